@@ -0,0 +1,344 @@
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "game_client.hpp"
+
+// Boty grajace z prawdziwym serwerem przez TCP, wszystkie w jednej petli
+// poll. Boty dziela sie na grupy po --room-size: pierwszy z grupy zaklada
+// pokoj i startuje gre, gdy wszyscy dolacza, pozostali dolaczaja. Kazdy bot
+// odpowiada od razu po GAME_STARTED i glosuje od razu po
+// VERIFICATION_START, wiec tempo gry wyznaczaja glownie przerwy miedzy
+// rundami z zestawu zasad.
+
+namespace {
+
+struct HarnessConfig {
+    std::string host = "127.0.0.1";
+    int port = 12345;
+    int bots = 100;
+    int roomSize = 4;
+    int games = 1;
+    std::string rules = "krotkie";
+    int seconds = 600;
+    int maxConnecting = 64;  // tyle polaczen naraz w trakcie nawiazywania (backlog serwera)
+};
+
+struct Bot {
+    int index = 0;
+    int fd = -1;
+    bool connecting = false;
+    bool done = false;
+    int gamesLeft = 0;
+    int generation = 0;
+    int64_t joinAt = 0;  // ms; 0 - nie ma na co czekac
+    GameClient client;
+};
+
+struct HarnessStats {
+    uint64_t gamesFinished = 0;
+    uint64_t gamesAborted = 0;
+    uint64_t failures = 0;
+    std::chrono::nanoseconds clientTime{0};
+};
+
+int64_t nowMs() {
+    using namespace std::chrono;
+    return duration_cast<milliseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+class Harness {
+public:
+    explicit Harness(const HarnessConfig& cfg) : config(cfg), bots(cfg.bots) {
+        for (int i = 0; i < config.bots; ++i) {
+            Bot& bot = bots[i];
+            bot.index = i;
+            bot.gamesLeft = config.games;
+            bot.client.setHandler([this, &bot](GameClient&, const GameClient::Event& event) { onEvent(bot, event); });
+            if (groupSize(bot) < 2) bot.done = true;
+        }
+    }
+
+    int run() {
+        int64_t deadline = nowMs() + config.seconds * 1000LL;
+        size_t nextToConnect = 0;
+        std::vector<pollfd> fds;
+        std::vector<Bot*> owners;
+
+        while (nowMs() < deadline) {
+            int connecting = 0;
+            size_t active = 0;
+            for (const Bot& bot : bots) {
+                connecting += bot.connecting;
+                active += !bot.done;
+            }
+            if (active == 0) break;
+            while (nextToConnect < bots.size() && connecting < config.maxConnecting) {
+                Bot& bot = bots[nextToConnect++];
+                if (bot.done) continue;
+                if (!startConnect(bot)) {
+                    stats.failures++;
+                    bot.done = true;
+                    continue;
+                }
+                connecting++;
+            }
+
+            fds.clear();
+            owners.clear();
+            int64_t now = nowMs();
+            int timeout = 100;
+            for (Bot& bot : bots) {
+                if (bot.fd < 0) continue;
+                short events = POLLIN;
+                if (bot.connecting || !bot.client.pendingOutput().empty()) events |= POLLOUT;
+                fds.push_back({bot.fd, events, 0});
+                owners.push_back(&bot);
+                if (bot.joinAt) timeout = std::min<int64_t>(timeout, std::max<int64_t>(0, bot.joinAt - now));
+            }
+
+            if (poll(fds.data(), fds.size(), timeout) < 0 && errno != EINTR) {
+                std::cerr << "poll: " << strerror(errno) << std::endl;
+                return 1;
+            }
+            for (size_t i = 0; i < fds.size(); ++i) {
+                if (fds[i].revents) onReady(*owners[i], fds[i].revents);
+            }
+
+            now = nowMs();
+            for (Bot& bot : bots) {
+                if (bot.joinAt && bot.joinAt <= now && bot.fd >= 0) {
+                    bot.joinAt = 0;
+                    bot.client.joinRoom(roomName(bot));
+                    flush(bot);
+                }
+            }
+        }
+        return 0;
+    }
+
+    void report(std::chrono::nanoseconds elapsed) const {
+        uint64_t framesIn = 0;
+        uint64_t framesOut = 0;
+        size_t unfinished = 0;
+        for (const Bot& bot : bots) {
+            framesIn += bot.client.framesReceived();
+            framesOut += bot.client.framesSentCount();
+            unfinished += !bot.done;
+        }
+        double seconds = std::chrono::duration<double>(elapsed).count();
+        double clientNs = static_cast<double>(stats.clientTime.count());
+        std::cout << "Boty: " << bots.size() << ", gry ukonczone: " << stats.gamesFinished
+                  << ", przerwane: " << stats.gamesAborted << ", bledy polaczen: " << stats.failures
+                  << ", niedokonczone boty: " << unfinished << std::endl;
+        std::cout << "Ramki odebrane: " << framesIn << ", wyslane: " << framesOut << std::endl;
+        std::cout << "Czas: " << seconds << " s, obsluga ramek po stronie klienta: " << clientNs / 1e6 << " ms ("
+                  << (framesIn ? clientNs / framesIn : 0) << " ns/ramke)" << std::endl;
+    }
+
+private:
+    HarnessConfig config;
+    std::vector<Bot> bots;
+    HarnessStats stats;
+
+    int groupSize(const Bot& bot) const {
+        int first = bot.index / config.roomSize * config.roomSize;
+        return std::min(config.roomSize, config.bots - first);
+    }
+
+    bool isHost(const Bot& bot) const {
+        return bot.index % config.roomSize == 0;
+    }
+
+    std::string roomName(const Bot& bot) const {
+        return "boty-" + std::to_string(bot.index / config.roomSize) + "-" + std::to_string(bot.generation);
+    }
+
+    bool startConnect(Bot& bot) {
+        int fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK, 0);
+        if (fd < 0) return false;
+        int one = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(config.port);
+        if (inet_pton(AF_INET, config.host.c_str(), &addr.sin_addr) != 1 ||
+            (connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0 && errno != EINPROGRESS)) {
+            close(fd);
+            return false;
+        }
+        bot.fd = fd;
+        bot.connecting = true;
+        return true;
+    }
+
+    void finish(Bot& bot) {
+        if (bot.fd >= 0) close(bot.fd);
+        bot.fd = -1;
+        bot.connecting = false;
+        bot.done = true;
+        bot.joinAt = 0;
+        bot.client.disconnected();
+    }
+
+    void onReady(Bot& bot, short revents) {
+        if (bot.connecting) {
+            int err = 0;
+            socklen_t len = sizeof(err);
+            getsockopt(bot.fd, SOL_SOCKET, SO_ERROR, &err, &len);
+            if (err != 0 || (revents & (POLLERR | POLLHUP))) {
+                stats.failures++;
+                finish(bot);
+                return;
+            }
+            if (!(revents & POLLOUT)) return;
+            bot.connecting = false;
+            bot.client.connected();
+            bot.client.login("bot" + std::to_string(bot.index));
+        }
+
+        if (revents & POLLIN) {
+            ssize_t n = recv(bot.fd, bot.client.prepareInput(4096), 4096, 0);
+            if (n <= 0) {
+                if (n < 0 && (errno == EAGAIN || errno == EINTR)) return;
+                finish(bot);
+                return;
+            }
+            auto start = std::chrono::steady_clock::now();
+            bool valid = bot.client.commitInput(static_cast<size_t>(n));
+            stats.clientTime += std::chrono::steady_clock::now() - start;
+            if (!valid) {
+                stats.failures++;
+                finish(bot);
+                return;
+            }
+        }
+        if (bot.fd >= 0) flush(bot);
+    }
+
+    void flush(Bot& bot) {
+        std::string_view out = bot.client.pendingOutput();
+        if (out.empty() || bot.connecting) return;
+        ssize_t n = send(bot.fd, out.data(), out.size(), MSG_NOSIGNAL);
+        if (n > 0) bot.client.consumeOutput(static_cast<size_t>(n));
+        else if (n < 0 && errno != EAGAIN && errno != EINTR) finish(bot);
+    }
+
+    // Kolejna gra grupy albo koniec pracy bota.
+    void nextGame(Bot& bot) {
+        if (--bot.gamesLeft <= 0) {
+            finish(bot);
+            return;
+        }
+        bot.generation++;
+        enterLobby(bot);
+    }
+
+    void enterLobby(Bot& bot) {
+        if (isHost(bot)) {
+            bot.client.createRoom(roomName(bot), config.rules);
+        } else {
+            bot.joinAt = nowMs() + 20;
+        }
+    }
+
+    void onEvent(Bot& bot, const GameClient::Event& event) {
+        GameClient& client = bot.client;
+        switch (event.type) {
+            case MsgType::LOGIN_OK:
+                enterLobby(bot);
+                break;
+            case MsgType::LOGIN_FAIL:
+            case MsgType::CREATE_ROOM_FAIL:
+                stats.failures++;
+                finish(bot);
+                break;
+            case MsgType::JOIN_ROOM_FAIL:
+                // Gospodarz moze jeszcze nie miec pokoju. Serwer przepuszcza
+                // 2 JOIN_ROOM na sekunde, a nadmiarowe gubi bez odpowiedzi.
+                bot.joinAt = nowMs() + 600;
+                break;
+            case MsgType::NEW_PLAYER_JOINED:
+                if (client.isHost() && static_cast<int>(client.players().size()) >= groupSize(bot)) client.startGame();
+                break;
+            case MsgType::GAME_STARTED: {
+                std::vector<std::string> answers;
+                for (const std::string& category : client.categories()) {
+                    answers.push_back(std::string(1, client.letter()) + category.substr(0, 3) + std::to_string(bot.index % 3));
+                }
+                client.submitAnswers(answers);
+                break;
+            }
+            case MsgType::VERIFICATION_START: {
+                // Wszyscy odrzucaja odpowiedzi konczace sie na '2'.
+                std::vector<std::pair<size_t, std::string>> vetoes;
+                const auto& categories = client.verification();
+                for (size_t c = 0; c < categories.size(); ++c) {
+                    const auto& category = categories[c];
+                    for (size_t i = 0; i < category.answers.size(); ++i) {
+                        bool known = i < category.verdicts.size() && category.verdicts[i] != '?';
+                        if (!known && category.answers[i].back() == '2') vetoes.emplace_back(c, category.answers[i]);
+                    }
+                }
+                client.sendVotes(vetoes);
+                break;
+            }
+            case MsgType::GAME_END:
+                if (isHost(bot)) stats.gamesFinished++;
+                nextGame(bot);
+                break;
+            case MsgType::HOST_LEFT:
+                stats.gamesAborted++;
+                nextGame(bot);
+                break;
+            default:
+                break;
+        }
+    }
+};
+
+}
+
+int main(int argc, char** argv) {
+    HarnessConfig config;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--host" && hasValue) config.host = argv[++i];
+        else if (arg == "--port" && hasValue) config.port = std::atoi(argv[++i]);
+        else if (arg == "--bots" && hasValue) config.bots = std::max(1, std::atoi(argv[++i]));
+        else if (arg == "--room-size" && hasValue) config.roomSize = std::max(2, std::atoi(argv[++i]));
+        else if (arg == "--games" && hasValue) config.games = std::max(1, std::atoi(argv[++i]));
+        else if (arg == "--rules" && hasValue) config.rules = argv[++i];
+        else if (arg == "--seconds" && hasValue) config.seconds = std::max(1, std::atoi(argv[++i]));
+        else {
+            std::cerr << "Uzycie: " << argv[0] << " [--host IP] [--port N] [--bots N] [--room-size N] [--games N]"
+                      << " [--rules ID] [--seconds N]" << std::endl;
+            return 1;
+        }
+    }
+
+    // Kazdy bot to jeden deskryptor.
+    rlimit limit;
+    if (getrlimit(RLIMIT_NOFILE, &limit) == 0 && limit.rlim_cur < limit.rlim_max) {
+        limit.rlim_cur = limit.rlim_max;
+        setrlimit(RLIMIT_NOFILE, &limit);
+    }
+
+    Harness harness(config);
+    auto start = std::chrono::steady_clock::now();
+    int rc = harness.run();
+    harness.report(std::chrono::steady_clock::now() - start);
+    return rc;
+}
@@ -0,0 +1,318 @@
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "protocol.hpp"
+#include "compression.hpp"
+#include "frame_reader.hpp"
+#include "messages.hpp"
+
+// Logika klienta bez gniazd i bez Qt: ramkowanie, dekompresja, odpowiedz na
+// PING i stan sesji (lobby, pokoj, runda, weryfikacja). Transport wklada
+// odebrane bajty przez prepareInput/commitInput, a wysyla to, co zwraca
+// pendingOutput. Dzieki temu ten sam kod obsluguje okno Qt i tysiace botow
+// w jednej petli poll.
+
+class GameClient {
+public:
+    enum class State {
+        DISCONNECTED,
+        CONNECTED,   // polaczony, przed LOGIN_OK / RESUME_OK
+        LOBBY,
+        ROOM,        // w pokoju, miedzy rundami albo przed gra
+        ROUND,       // trwa wpisywanie odpowiedzi
+        VERIFY       // trwa glosowanie
+    };
+
+    // Ramka od serwera po dekompresji i sprawdzeniu tresci; w chwili
+    // wywolania stan klienta jest juz po tej ramce.
+    struct Event {
+        MsgType type;
+        std::string_view body;
+    };
+    using EventHandler = std::function<void(GameClient&, const Event&)>;
+
+    struct VerifyCategory {
+        std::string name;
+        std::vector<std::string> answers;
+        std::string verdicts;  // '+', '-', '?' na odpowiedz albo pusty
+    };
+
+    void setHandler(EventHandler fn) {
+        handler = std::move(fn);
+    }
+
+    // --- transport ---
+
+    void connected() {
+        reset();
+        currentState = State::CONNECTED;
+    }
+
+    void disconnected() {
+        reset();
+        currentState = State::DISCONNECTED;
+    }
+
+    char* prepareInput(size_t n) {
+        return reader.prepare(n);
+    }
+
+    // Zwraca false przy blednej ramce; transport powinien wtedy rozlaczyc.
+    bool commitInput(size_t n) {
+        reader.commit(n);
+        return processInput();
+    }
+
+    bool receive(const char* data, size_t n) {
+        reader.append(data, n);
+        return processInput();
+    }
+
+    std::string_view pendingOutput() const {
+        return std::string_view(outgoing.data() + outgoingPos, outgoing.size() - outgoingPos);
+    }
+
+    void consumeOutput(size_t n) {
+        outgoingPos += n;
+        if (outgoingPos >= outgoing.size()) {
+            outgoing.clear();
+            outgoingPos = 0;
+        }
+    }
+
+    // --- komendy ---
+
+    // acceptCompressed: flaga kompresji w LOGIN/RESUME zglasza, ze klient
+    // przyjmuje skompresowane ramki.
+    void send(MsgType type, std::string_view data, bool acceptCompressed = false) {
+        size_t at = outgoing.size();
+        MsgHeader header{type, htonl(static_cast<uint32_t>(data.size()))};
+        if (acceptCompressed) header.type = static_cast<MsgType>(static_cast<uint8_t>(type) | kFrameFlagCompressed);
+        outgoing.resize(at + sizeof(header) + data.size());
+        std::memcpy(outgoing.data() + at, &header, sizeof(header));
+        std::memcpy(outgoing.data() + at + sizeof(header), data.data(), data.size());
+        framesSent++;
+
+        // LEAVE_ROOM nie ma odpowiedzi; pokoj opuszczamy od razu.
+        if (type == MsgType::LEAVE_ROOM && currentState >= State::ROOM) leaveRoomLocally();
+        if (type == MsgType::LOGIN) pendingNick.assign(data);
+    }
+
+    void login(std::string_view nick, bool acceptCompressed = true) {
+        send(MsgType::LOGIN, nick, acceptCompressed);
+    }
+
+    void resume(std::string_view token, bool acceptCompressed = true) {
+        send(MsgType::RESUME, token, acceptCompressed);
+    }
+
+    void createRoom(std::string_view name, std::string_view rulesId = {}) {
+        std::string data(name);
+        if (!rulesId.empty()) data += ";" + std::string(rulesId);
+        send(MsgType::CREATE_ROOM, data);
+    }
+
+    void joinRoom(std::string_view name) {
+        send(MsgType::JOIN_ROOM, name);
+    }
+
+    void startGame() {
+        send(MsgType::START_GAME, "");
+    }
+
+    // Znaki rozdzielajace (kAnswerSeparators) sa z odpowiedzi usuwane;
+    // serwer odpowiedz z nimi uznalby za pusta.
+    void submitAnswers(const std::vector<std::string>& answers) {
+        std::string data;
+        for (size_t i = 0; i < answers.size(); ++i) {
+            if (i) data += ';';
+            for (char c : answers[i]) {
+                if (kAnswerSeparators.find(c) == std::string_view::npos) data += c;
+            }
+        }
+        send(MsgType::SUBMIT_ANSWERS, data);
+        answersSent = true;
+    }
+
+    // vetoes: pary (indeks kategorii, odpowiedz) uznane za bledne.
+    void sendVotes(const std::vector<std::pair<size_t, std::string>>& vetoes) {
+        std::string data;
+        for (const auto& [category, answer] : vetoes) data += std::to_string(category) + ":" + answer + ";";
+        send(MsgType::SEND_VOTE, data);
+        votesSent = true;
+    }
+
+    void leaveRoom() {
+        send(MsgType::LEAVE_ROOM, "");
+    }
+
+    void requestRoomList() {
+        send(MsgType::GET_ROOM_LIST, "");
+    }
+
+    // --- stan ---
+
+    State state() const { return currentState; }
+    const std::string& nick() const { return myNick; }
+    const std::string& resumeToken() const { return token; }
+    const std::string& room() const { return roomName; }
+    const std::vector<std::string>& players() const { return roomPlayers; }
+    bool isHost() const { return host; }
+    bool isSpectating() const { return spectating; }
+    char letter() const { return roundLetter; }
+    int round() const { return currentRound; }
+    int maxRounds() const { return roundCount; }
+    int secondsLeft() const { return timeLeft; }
+    const std::vector<std::string>& categories() const { return roundCategories; }
+    const std::vector<VerifyCategory>& verification() const { return verifyCategories; }
+    bool hasSubmittedAnswers() const { return answersSent; }
+    bool hasVoted() const { return votesSent; }
+    uint64_t framesReceived() const { return framesIn; }
+    uint64_t framesSentCount() const { return framesSent; }
+
+private:
+    EventHandler handler;
+    FrameReader reader;
+    std::vector<char> outgoing;
+    size_t outgoingPos = 0;
+    std::string inflated;
+
+    State currentState = State::DISCONNECTED;
+    std::string pendingNick;
+    std::string myNick;
+    std::string token;
+    std::string roomName;
+    std::vector<std::string> roomPlayers;
+    bool host = false;
+    bool spectating = false;
+    char roundLetter = 0;
+    int currentRound = 0;
+    int roundCount = 0;
+    int timeLeft = 0;
+    std::vector<std::string> roundCategories;
+    std::vector<VerifyCategory> verifyCategories;
+    bool answersSent = false;
+    bool votesSent = false;
+    uint64_t framesIn = 0;
+    uint64_t framesSent = 0;
+
+    void reset() {
+        reader.clear();
+        outgoing.clear();
+        outgoingPos = 0;
+        leaveRoomLocally();
+    }
+
+    void leaveRoomLocally() {
+        roomName.clear();
+        roomPlayers.clear();
+        host = false;
+        spectating = false;
+        roundCategories.clear();
+        verifyCategories.clear();
+        if (currentState >= State::ROOM) currentState = State::LOBBY;
+    }
+
+    bool processInput() {
+        MsgHeader header;
+        std::string_view body;
+        FrameReader::Status status;
+        while ((status = reader.next(MSG_TO_CLIENT, header, body)) == FrameReader::Status::FRAME) {
+            if (hasCompressedFlag(header.type)) {
+                if (!decompressPayload(header.type, body, inflated)) return false;
+                header.type = frameType(header.type);
+                body = inflated;
+            }
+            if (!isValidPayload(header.type, body)) continue;
+            framesIn++;
+            if (header.type == MsgType::PING) {
+                send(MsgType::PONG, "");
+                continue;
+            }
+            apply(header.type, body);
+            if (handler) handler(*this, Event{header.type, body});
+        }
+        return status != FrameReader::Status::INVALID;
+    }
+
+    void enterRoom(std::string_view name, const std::vector<std::string_view>& players, bool asHost) {
+        roomName.assign(name);
+        roomPlayers.assign(players.begin(), players.end());
+        host = asHost;
+        currentState = State::ROOM;
+    }
+
+    void apply(MsgType type, std::string_view body) {
+        switch (type) {
+            case MsgType::LOGIN_OK:
+                myNick = pendingNick;
+                token.assign(body);
+                currentState = State::LOBBY;
+                break;
+            case MsgType::RESUME_OK: {
+                ResumeOkView view = decodeResumeOk(body);
+                myNick.assign(view.nick);
+                currentState = State::LOBBY;
+                if (!view.room.empty()) enterRoom(view.room, view.players, false);
+                break;
+            }
+            case MsgType::CREATE_ROOM_OK:
+                enterRoom(body, {myNick}, true);
+                break;
+            case MsgType::JOIN_ROOM_OK:
+            case MsgType::SPECTATE_OK: {
+                RoomMembersView view = decodeRoomMembers(body);
+                enterRoom(view.room, view.players, false);
+                spectating = type == MsgType::SPECTATE_OK;
+                break;
+            }
+            case MsgType::NEW_PLAYER_JOINED:
+                roomPlayers.emplace_back(body);
+                break;
+            case MsgType::PLAYER_LEFT:
+                roomPlayers.erase(std::remove(roomPlayers.begin(), roomPlayers.end(), body), roomPlayers.end());
+                break;
+            case MsgType::HOST_CHANGED:
+                host = body == myNick;
+                break;
+            case MsgType::HOST_LEFT:
+            case MsgType::GAME_END:
+                leaveRoomLocally();
+                break;
+            case MsgType::GAME_STARTED: {
+                GameStartedView view = decodeGameStarted(body);
+                if (view.fields < 5) break;
+                roundLetter = view.letter.empty() ? 0 : view.letter[0];
+                currentRound = view.round;
+                roundCount = view.maxRounds;
+                timeLeft = view.seconds;
+                roundCategories.assign(view.categories.begin(), view.categories.end());
+                answersSent = false;
+                votesSent = false;
+                currentState = State::ROUND;
+                break;
+            }
+            case MsgType::TIME_LEFT:
+                timeLeft = decodeNumber(body);
+                break;
+            case MsgType::VERIFICATION_START:
+                verifyCategories.clear();
+                for (auto& view : decodeVerification(body)) {
+                    verifyCategories.push_back(VerifyCategory{std::string(view.name),
+                        std::vector<std::string>(view.answers.begin(), view.answers.end()), std::move(view.verdicts)});
+                }
+                currentState = State::VERIFY;
+                break;
+            case MsgType::ROUND_END:
+                currentState = State::ROOM;
+                break;
+            default:
+                break;
+        }
+    }
+};
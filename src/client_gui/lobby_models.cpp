@@ -0,0 +1,120 @@
+#include "lobby_models.hpp"
+
+RoomListModel::RoomListModel(QObject *parent) : QAbstractListModel(parent) {}
+
+void RoomListModel::update(const QVector<RoomEntry> &fresh) {
+    QHash<QString, int> freshByName;
+    for (int i = 0; i < fresh.size(); ++i) freshByName.insert(fresh[i].name, i);
+
+    // Znikniete pokoje usuwamy od konca, ciaglymi blokami wierszy.
+    bool removed = false;
+    int row = static_cast<int>(rooms.size()) - 1;
+    while (row >= 0) {
+        if (freshByName.contains(rooms[row].name)) {
+            --row;
+            continue;
+        }
+        int last = row;
+        while (row > 0 && !freshByName.contains(rooms[row - 1].name)) --row;
+        beginRemoveRows(QModelIndex(), row, last);
+        rooms.remove(row, last - row + 1);
+        endRemoveRows();
+        removed = true;
+        --row;
+    }
+    if (removed) {
+        rowByName.clear();
+        reindex(0);
+    }
+
+    for (int i = 0; i < rooms.size(); ++i) {
+        const RoomEntry &entry = fresh[freshByName.value(rooms[i].name)];
+        if (entry.inProgress == rooms[i].inProgress) continue;
+        rooms[i].inProgress = entry.inProgress;
+        emit dataChanged(index(i), index(i), {Qt::DisplayRole});
+    }
+
+    QVector<RoomEntry> added;
+    for (const RoomEntry &entry : fresh) {
+        if (rowByName.contains(entry.name)) continue;
+        rowByName.insert(entry.name, static_cast<int>(rooms.size() + added.size()));
+        added.append(entry);
+    }
+    if (added.isEmpty()) return;
+    int first = static_cast<int>(rooms.size());
+    beginInsertRows(QModelIndex(), first, first + static_cast<int>(added.size()) - 1);
+    rooms += added;
+    endInsertRows();
+}
+
+QString RoomListModel::nameAt(int row) const {
+    return row >= 0 && row < rooms.size() ? rooms[row].name : QString();
+}
+
+void RoomListModel::reindex(int from) {
+    for (int i = from; i < rooms.size(); ++i) rowByName.insert(rooms[i].name, i);
+}
+
+int RoomListModel::rowCount(const QModelIndex &parent) const {
+    return parent.isValid() ? 0 : static_cast<int>(rooms.size());
+}
+
+QVariant RoomListModel::data(const QModelIndex &index, int role) const {
+    if (!index.isValid() || index.row() >= rowCount()) return QVariant();
+    const RoomEntry &room = rooms[index.row()];
+    if (role == Qt::DisplayRole) return room.name + " | " + (room.inProgress ? "In progress" : "Waiting");
+    if (role == Qt::UserRole) return room.name;
+    return QVariant();
+}
+
+PlayerListModel::PlayerListModel(QObject *parent) : QAbstractListModel(parent) {}
+
+void PlayerListModel::setPlayers(const QStringList &nicks, const QString &self) {
+    beginResetModel();
+    players.clear();
+    rowByNick.clear();
+    for (const QString &nick : nicks) {
+        if (nick.isEmpty() || rowByNick.contains(nick)) continue;
+        rowByNick.insert(nick, static_cast<int>(players.size()));
+        players.append({nick, nick == self});
+    }
+    endResetModel();
+}
+
+void PlayerListModel::add(const QString &nick, bool self) {
+    if (nick.isEmpty() || rowByNick.contains(nick)) return;
+    int row = static_cast<int>(players.size());
+    beginInsertRows(QModelIndex(), row, row);
+    players.append({nick, self});
+    rowByNick.insert(nick, row);
+    endInsertRows();
+}
+
+bool PlayerListModel::remove(const QString &nick) {
+    int row = rowByNick.value(nick, -1);
+    if (row < 0) return false;
+    beginRemoveRows(QModelIndex(), row, row);
+    players.remove(row);
+    rowByNick.remove(nick);
+    reindex(row);
+    endRemoveRows();
+    return true;
+}
+
+void PlayerListModel::clear() {
+    setPlayers({});
+}
+
+void PlayerListModel::reindex(int from) {
+    for (int i = from; i < players.size(); ++i) rowByNick.insert(players[i].nick, i);
+}
+
+int PlayerListModel::rowCount(const QModelIndex &parent) const {
+    return parent.isValid() ? 0 : static_cast<int>(players.size());
+}
+
+QVariant PlayerListModel::data(const QModelIndex &index, int role) const {
+    if (!index.isValid() || index.row() >= rowCount() || role != Qt::DisplayRole) return QVariant();
+    const Player &player = players[index.row()];
+    return player.self ? player.nick + " (Ty)" : player.nick;
+}
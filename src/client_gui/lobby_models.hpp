@@ -0,0 +1,56 @@
+#pragma once
+#include <QAbstractListModel>
+#include <QHash>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include "net_worker.hpp"
+
+// Lista pokoi w lobby. Odswiezenie porownuje nowa liste z obecna po nazwie
+// pokoju i zglasza widokowi tylko usuniete, dodane i zmienione wiersze,
+// wiec zaznaczenie i przewiniecie zostaja na miejscu.
+class RoomListModel : public QAbstractListModel {
+    Q_OBJECT
+
+public:
+    explicit RoomListModel(QObject *parent = nullptr);
+
+    void update(const QVector<RoomEntry> &rooms);
+    QString nameAt(int row) const;
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+
+private:
+    QVector<RoomEntry> rooms;
+    QHash<QString, int> rowByName;
+
+    void reindex(int from);
+};
+
+// Gracze w pokoju, z wyszukiwaniem wiersza po nicku.
+class PlayerListModel : public QAbstractListModel {
+    Q_OBJECT
+
+public:
+    explicit PlayerListModel(QObject *parent = nullptr);
+
+    void setPlayers(const QStringList &nicks, const QString &self = QString());
+    void add(const QString &nick, bool self = false);
+    bool remove(const QString &nick);
+    void clear();
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+
+private:
+    struct Player {
+        QString nick;
+        bool self = false;
+    };
+
+    QVector<Player> players;
+    QHash<QString, int> rowByNick;
+
+    void reindex(int from);
+};
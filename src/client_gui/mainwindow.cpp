@@ -5,17 +5,20 @@
 #include <QMessageBox>
 #include <QGroupBox>
 #include <QFormLayout>
-#include <QScrollArea>
+#include <charconv>
 
 MainWindow::MainWindow(QWidget *parent) : QMainWindow(parent) {
     setupUI();
 
-    socket = new QTcpSocket(this);
+    qRegisterMetaType<QVector<NetEvent>>("QVector<NetEvent>");
+    netThread = new QThread(this);
+    worker = new NetWorker();
+    worker->moveToThread(netThread);
+    connect(netThread, &QThread::started, worker, &NetWorker::start);
+    connect(netThread, &QThread::finished, worker, &QObject::deleteLater);
+    connect(worker, &NetWorker::eventsReady, this, &MainWindow::onNetEvents);
+    netThread->start();
 
-    connect(socket, &QTcpSocket::readyRead, this, &MainWindow::onReadyRead);
-    connect(socket, &QTcpSocket::connected, this, &MainWindow::onConnected);
-    connect(socket, &QTcpSocket::disconnected, this, &MainWindow::onDisconnected);
-    connect(socket, SIGNAL(error(QAbstractSocket::SocketError)), this, SLOT(onError(QAbstractSocket::SocketError)));
     roundResultsBackdrop = nullptr;
     roundResultsWidget = nullptr;
     roundResultsLabel = nullptr;
@@ -26,18 +29,29 @@ MainWindow::MainWindow(QWidget *parent) : QMainWindow(parent) {
     connectTimer = new QTimer(this);
     connectTimer->setSingleShot(true);
     connect(connectTimer, &QTimer::timeout, this, &MainWindow::onConnectTimeout);
+
+    reconnectTimer = new QTimer(this);
+    reconnectTimer->setSingleShot(true);
+    connect(reconnectTimer, &QTimer::timeout, this, &MainWindow::attemptReconnect);
 }
 
-void MainWindow::onError(QAbstractSocket::SocketError) {
+void MainWindow::onError(const QString &error) {
+    if (reconnecting) {
+        scheduleReconnect();
+        return;
+    }
     if (stackedWidget->currentIndex() == 0) {
-         QMessageBox::critical(this, "Błąd", socket->errorString());
+         QMessageBox::critical(this, "Błąd", error);
          connectButton->setEnabled(true);
          connectButton->setText("Graj!");
          connectTimer->stop();
     }
 }
 
-MainWindow::~MainWindow() {}
+MainWindow::~MainWindow() {
+    netThread->quit();
+    netThread->wait();
+}
 
 void MainWindow::setupUI() {
     stackedWidget = new QStackedWidget(this);
@@ -83,9 +97,16 @@ void MainWindow::setupUI() {
     QVBoxLayout *createLayout = new QVBoxLayout(createGroup);
     roomNameInput = new QLineEdit();
     roomNameInput->setPlaceholderText("Nazwa pokoju");
+    rulesCombo = new QComboBox();
+    for (const RuleSet &rules : rulePresets()) {
+        QString label = QString::fromStdString(rules.id) + " (" + QString::number(int(rules.categoryCount())) + " kategorii, "
+                      + QString::number(rules.maxRounds) + " rundy, " + QString::number(rules.answerSeconds) + "s)";
+        rulesCombo->addItem(label, QString::fromStdString(rules.id));
+    }
     QPushButton *createBtn = new QPushButton("Stwórz");
     connect(createBtn, &QPushButton::clicked, this, &MainWindow::onCreateRoomClicked);
     createLayout->addWidget(roomNameInput);
+    createLayout->addWidget(rulesCombo);
     createLayout->addWidget(createBtn);
 
     QGroupBox *joinGroup = new QGroupBox("Dołącz do Pokoju", lobbyPage);
@@ -94,12 +115,26 @@ void MainWindow::setupUI() {
     roomNameInputJoin->setPlaceholderText("Nazwa Pokoju");
     QPushButton *joinBtn = new QPushButton("Dołącz");
     connect(joinBtn, &QPushButton::clicked, this, &MainWindow::onJoinRoomClicked);
+    QPushButton *spectateBtn = new QPushButton("Obserwuj");
+    connect(spectateBtn, &QPushButton::clicked, this, &MainWindow::onSpectateRoomClicked);
     joinLayout->addWidget(roomNameInputJoin);
     joinLayout->addWidget(joinBtn);
-
-    roomList = new QListWidget();
+    joinLayout->addWidget(spectateBtn);
+
+    roomModel = new RoomListModel(this);
+    roomList = new QListView();
+    roomList->setUniformItemSizes(true);
+    roomList->setModel(roomModel);
+    roomList->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    connect(roomList, &QListView::clicked, this, [this](const QModelIndex &index) {
+        roomNameInputJoin->setText(roomModel->nameAt(index.row()));
+    });
     refreshButton = new QPushButton("Odśwież listę pokoi");
     connect(refreshButton, &QPushButton::clicked, this, &MainWindow::onRefreshRoomsClicked);
+    leaderboardButton = new QPushButton("Ranking graczy");
+    connect(leaderboardButton, &QPushButton::clicked, this, &MainWindow::onLeaderboardClicked);
+    tournamentButton = new QPushButton("Dołącz do turnieju");
+    connect(tournamentButton, &QPushButton::clicked, this, &MainWindow::onTournamentJoinClicked);
 
     lobbyLog = new QTextEdit();
     lobbyLog->setReadOnly(true);
@@ -109,6 +144,8 @@ void MainWindow::setupUI() {
     lobbyLayout->addWidget(new QLabel("Dostępne pokoje:"));
     lobbyLayout->addWidget(roomList);
     lobbyLayout->addWidget(refreshButton);
+    lobbyLayout->addWidget(leaderboardButton);
+    lobbyLayout->addWidget(tournamentButton);
     lobbyLayout->addWidget(new QLabel("Logi:"));
     lobbyLayout->addWidget(lobbyLog);
 
@@ -119,7 +156,10 @@ void MainWindow::setupUI() {
     roomTitleLabel->setStyleSheet("font-size: 18px; font-weight: bold;");
     roomTitleLabel->setAlignment(Qt::AlignCenter);
 
-    playerList = new QListWidget();
+    playerModel = new PlayerListModel(this);
+    playerList = new QListView();
+    playerList->setModel(playerModel);
+    playerList->setEditTriggers(QAbstractItemView::NoEditTriggers);
     
     startGameButton = new QPushButton("START GRY (Tylko Host)");
     startGameButton->setEnabled(false);
@@ -154,18 +194,7 @@ void MainWindow::setupUI() {
     timeLeftLabel->setStyleSheet("font-size: 20px; color: red;");
     timeLeftLabel->setAlignment(Qt::AlignCenter);
     
-    QFormLayout *form = new QFormLayout();
-    inputCountry = new QLineEdit();
-    inputCity = new QLineEdit();
-    inputAnimal = new QLineEdit();
-    inputPlant = new QLineEdit();
-    inputObject = new QLineEdit();
-    
-    form->addRow("Państwo:", inputCountry);
-    form->addRow("Miasto:", inputCity);
-    form->addRow("Zwierzę:", inputAnimal);
-    form->addRow("Roślina:", inputPlant);
-    form->addRow("Rzecz:", inputObject);
+    answerForm = new QFormLayout();
     
     submitButton = new QPushButton("Wyślij Odpowiedzi!");
     submitButton->setStyleSheet("background-color: green; color: white; font-weight: bold; padding: 10px;");
@@ -174,7 +203,7 @@ void MainWindow::setupUI() {
     gameLayout->addWidget(letterLabel);
     gameLayout->addWidget(roundLabel);
     gameLayout->addWidget(timeLeftLabel);
-    gameLayout->addLayout(form);
+    gameLayout->addLayout(answerForm);
     gameLayout->addWidget(submitButton);
     gameLayout->addStretch();
     
@@ -185,18 +214,16 @@ void MainWindow::setupUI() {
     verLabel->setAlignment(Qt::AlignCenter);
     verLabel->setStyleSheet("font-weight: bold; color: red;");
     
-    QScrollArea *scroll = new QScrollArea();
-    QWidget *scrollContent = new QWidget();
-    verifyLayoutContainer = new QVBoxLayout(scrollContent);
-    scroll->setWidget(scrollContent);
-    scroll->setWidgetResizable(true);
+    // Kazda kategoria ma wlasna, przewijana liste; sekcje powstaja w
+    // setupVerificationUI i sa uzywane ponownie w kolejnych rundach.
+    verifyLayoutContainer = new QVBoxLayout();
     
     submitVotesButton = new QPushButton("Zatwierdź głosy");
     submitVotesButton->setStyleSheet("background-color: blue; color: white; padding: 10px;");
     connect(submitVotesButton, &QPushButton::clicked, this, &MainWindow::onSubmitVotesClicked);
     
     mainVerifyLayout->addWidget(verLabel);
-    mainVerifyLayout->addWidget(scroll);
+    mainVerifyLayout->addLayout(verifyLayoutContainer);
     mainVerifyLayout->addWidget(submitVotesButton);
 
     finalScorePage = new QWidget();
@@ -237,13 +264,18 @@ void MainWindow::onConnectClicked() {
     if (host.isEmpty()) host = "127.0.0.1";
     int port = serverPortInput->text().toInt();
     if (port <= 0) port = 12345;
-    socket->connectToHost(host, static_cast<quint16>(port));
+    serverHost = host;
+    serverPort = static_cast<quint16>(port);
+    resumeToken.clear();
+    QMetaObject::invokeMethod(worker, [worker = worker, host = serverHost, port = serverPort] {
+        worker->connectToHost(host, port);
+    }, Qt::QueuedConnection);
     connectButton->setText("Łączenie...");
     connectTimer->start(8000);
 }
 
 void MainWindow::onConnectTimeout() {
-    socket->abort();
+    QMetaObject::invokeMethod(worker, &NetWorker::abort, Qt::QueuedConnection);
     connectTimer->stop();
     connectButton->setEnabled(true);
     connectButton->setText("Graj!");
@@ -257,9 +289,8 @@ void MainWindow::onCreateRoomClicked() {
     QString name = roomNameInput->text();
     if (name.isEmpty()) return;
     
-    std::string data = name.toStdString();
-    auto msg = createMessage(MsgType::CREATE_ROOM, data);
-    socket->write(msg.data(), msg.size());
+    std::string data = name.toStdString() + ";" + rulesCombo->currentData().toString().toStdString();
+    sendMessage(MsgType::CREATE_ROOM, data);
 }
 
 void MainWindow::onJoinRoomClicked() {
@@ -267,106 +298,128 @@ void MainWindow::onJoinRoomClicked() {
     if (name.isEmpty()) return;
     
     std::string data = name.toStdString();
-    auto msg = createMessage(MsgType::JOIN_ROOM, data);
-    socket->write(msg.data(), msg.size());
+    sendMessage(MsgType::JOIN_ROOM, data);
+}
+
+void MainWindow::onSpectateRoomClicked() {
+    QString name = roomNameInputJoin->text();
+    if (name.isEmpty()) return;
+
+    std::string data = name.toStdString();
+    sendMessage(MsgType::SPECTATE_ROOM, data);
 }
 
 void MainWindow::onStartGameClicked() {
-    auto msg = createMessage(MsgType::START_GAME, "");
-    socket->write(msg.data(), msg.size());
+    sendMessage(MsgType::START_GAME, "");
 }
 
 void MainWindow::onLeaveRoomClicked() {
-    auto msg = createMessage(MsgType::LEAVE_ROOM, "");
-    socket->write(msg.data(), msg.size());
+    sendMessage(MsgType::LEAVE_ROOM, "");
     goToLobby();
 }
 
 void MainWindow::onSubmitAnswersClicked() {
-    QString answers = inputCountry->text() + ";" + 
-                      inputCity->text() + ";" + 
-                      inputAnimal->text() + ";" + 
-                      inputPlant->text() + ";" + 
-                      inputObject->text();
-                      
+    QStringList fields;
+    // Separatory protokolu (kAnswerSeparators) nie moga trafic do odpowiedzi.
+    for (QLineEdit *input : answerInputs) fields.append(input->text().remove(';').remove(':').remove(','));
+    QString answers = fields.join(";");
+
     std::string data = answers.toStdString();
-    auto msg = createMessage(MsgType::SUBMIT_ANSWERS, data);
-    socket->write(msg.data(), msg.size());
+    sendMessage(MsgType::SUBMIT_ANSWERS, data);
     
     submitButton->setEnabled(false);
     submitButton->setText("Wysłano! Czekaj na innych...");
 }
 
-void MainWindow::setupVerificationUI(const QString &data) {
-    QLayoutItem *item;
-    while ((item = verifyLayoutContainer->takeAt(0)) != nullptr) {
-        delete item->widget();
-        delete item;
+// Pola odpowiedzi sa budowane z listy kategorii przyslanej w GAME_STARTED;
+// przy tej samej liscie istniejace pola sa tylko czyszczone.
+void MainWindow::setupAnswerInputs(const QStringList &categories) {
+    if (categories == answerCategories) {
+        clearAnswerInputs();
+        return;
     }
-    voteCheckboxes.clear();
-    
-    QStringList categories = data.split(";");
-    int catIdx = 0;
-    
-    for (const QString &catStr : categories) {
-        if (catStr.trimmed().isEmpty()) continue;
-        
-        QStringList parts = catStr.split(":");
-        if (parts.size() < 2) continue;
-        
-        QString catName = parts[0];
-        QStringList answers = parts[1].split(",");
-        
-        QLabel *catLabel = new QLabel(catName);
-        catLabel->setStyleSheet("font-weight: bold; margin-top: 10px;");
-        verifyLayoutContainer->addWidget(catLabel);
-        
-        for (const QString &ans : answers) {
-            if (ans.trimmed().isEmpty()) continue;
-            QCheckBox *cb = new QCheckBox(ans);
-            verifyLayoutContainer->addWidget(cb);
-            voteCheckboxes.push_back({catIdx, cb});
+    while (answerForm->rowCount() > 0) answerForm->removeRow(0);
+    answerInputs.clear();
+    answerCategories = categories;
+    for (const QString &category : categories) {
+        QLineEdit *input = new QLineEdit();
+        answerForm->addRow(category + ":", input);
+        answerInputs.push_back(input);
+    }
+}
+
+void MainWindow::clearAnswerInputs() {
+    for (QLineEdit *input : answerInputs) input->clear();
+}
+
+void MainWindow::setupVerificationUI(const QVector<VerificationCategory> &categories) {
+    while (verifySections.size() < categories.size()) {
+        VerifySection section;
+        section.label = new QLabel();
+        section.label->setStyleSheet("font-weight: bold; margin-top: 10px;");
+        section.model = new VerificationModel(this);
+        section.view = new QListView();
+        section.view->setUniformItemSizes(true);
+        section.view->setModel(section.model);
+        verifyLayoutContainer->addWidget(section.label);
+        verifyLayoutContainer->addWidget(section.view, 1);
+        verifySections.append(section);
+    }
+
+    for (qsizetype i = 0; i < verifySections.size(); ++i) {
+        VerifySection &section = verifySections[i];
+        bool used = i < categories.size();
+        if (used) {
+            section.label->setText(categories[i].name);
+            section.model->reset(categories[i]);
+        } else {
+            section.model->clear();
         }
-        catIdx++;
+        section.label->setVisible(used);
+        section.view->setVisible(used);
     }
-    
-    verifyLayoutContainer->addStretch();
 }
 
 void MainWindow::onSubmitVotesClicked() {
     QString voteData = "";
     
-    for (auto &pair : voteCheckboxes) {
-        if (pair.second->isChecked()) {
-            voteData += QString::number(pair.first) + ":" + pair.second->text() + ";";
-        }
+    for (qsizetype catIdx = 0; catIdx < verifySections.size(); ++catIdx) {
+        QString prefix = QString::number(catIdx) + ":";
+        verifySections[catIdx].model->forEachVeto([&](const QString &answer) {
+            voteData += prefix + answer + ";";
+        });
     }
     
     std::string data = voteData.toStdString();
-    auto msg = createMessage(MsgType::SEND_VOTE, data);
-    socket->write(msg.data(), msg.size());
+    sendMessage(MsgType::SEND_VOTE, data);
     
     submitVotesButton->setEnabled(false);
     submitVotesButton->setText("Głosy wysłane. Czekaj na wyniki...");
 }
 
 void MainWindow::onRefreshRoomsClicked() {
-    auto msg = createMessage(MsgType::GET_ROOM_LIST, "");
-    socket->write(msg.data(), msg.size());
+    sendMessage(MsgType::GET_ROOM_LIST, "");
+}
+
+void MainWindow::onLeaderboardClicked() {
+    sendMessage(MsgType::GET_LEADERBOARD, "10");
+}
+
+void MainWindow::onTournamentJoinClicked() {
+    sendMessage(MsgType::TOURNAMENT_JOIN, "");
 }
 
 void MainWindow::goToLobby() {
     finalScoreTimer->stop();
+    spectating = false;
+    roomHost = false;
     stackedWidget->setCurrentIndex(1);
-    playerList->clear();
+    playerModel->clear();
     lobbyLog->clear();
     gameLog->clear();
     submitButton->setEnabled(true);
     submitButton->setText("Wyślij Odpowiedzi!");
-    inputCountry->clear();
-    inputCity->clear();
-    inputAnimal->clear();
-    inputPlant->clear();
+    clearAnswerInputs();
     if (roundResultsWidget) {
         roundResultsWidget->close();
         roundResultsWidget = nullptr;
@@ -379,25 +432,69 @@ void MainWindow::goToLobby() {
 }
 void MainWindow::onConnected() {
     if (connectTimer) connectTimer->stop();
+    if (reconnecting) {
+        sendMessage(MsgType::RESUME, resumeToken.toStdString(), true);
+    } else {
+        sendMessage(MsgType::LOGIN, nickInput->text().toStdString(), true);
+    }
+}
 
-    std::string nick = nickInput->text().toStdString();
-    auto msg = createMessage(MsgType::LOGIN, nick);
-    socket->write(msg.data(), msg.size());
+// Flaga kompresji w LOGIN/RESUME oznacza, ze klient przyjmuje skompresowane ramki.
+void MainWindow::sendMessage(MsgType type, const std::string &data, bool acceptCompressed) {
+    QByteArray payload(data.data(), static_cast<qsizetype>(data.size()));
+    QMetaObject::invokeMethod(worker, [worker = worker, type, payload, acceptCompressed] {
+        worker->send(type, payload, acceptCompressed);
+    }, Qt::QueuedConnection);
 }
 
 void MainWindow::onDisconnected() {
+    // Serwer trzyma sesje jeszcze przez chwile, wiec po zerwaniu polaczenia
+    // probujemy wrocic do tej samej gry zamiast do ekranu logowania.
+    if (!resumeToken.isEmpty() && stackedWidget->currentIndex() != 0) {
+        if (!reconnecting) log("Utracono połączenie z serwerem, wznawianie...");
+        reconnecting = true;
+        scheduleReconnect();
+        return;
+    }
     if (stackedWidget->currentIndex() != 0) {
         QMessageBox::critical(this, "Rozłączono", "Połączenie z serwerem przerwane.");
     }
+    resetToLoginPage();
+}
+
+void MainWindow::scheduleReconnect() {
+    static constexpr int kMaxReconnectAttempts = 6;
+    if (reconnectTimer->isActive()) return;
+    if (reconnectAttempts >= kMaxReconnectAttempts) {
+        resumeToken.clear();
+        resetToLoginPage();
+        QMessageBox::critical(this, "Rozłączono", "Nie udało się wznowić połączenia z serwerem.");
+        return;
+    }
+    reconnectTimer->start(std::min(500 << reconnectAttempts, 8000));
+    reconnectAttempts++;
+}
+
+void MainWindow::attemptReconnect() {
+    QMetaObject::invokeMethod(worker, [worker = worker, host = serverHost, port = serverPort] {
+        worker->connectToHost(host, port);
+    }, Qt::QueuedConnection);
+}
+
+void MainWindow::resetToLoginPage() {
+    reconnecting = false;
+    reconnectAttempts = 0;
+    reconnectTimer->stop();
     stackedWidget->setCurrentIndex(0);
     connectButton->setEnabled(true);
-    playerList->clear();
+    spectating = false;
+    playerModel->clear();
     lobbyLog->clear();
     gameLog->clear();
     
     submitButton->setEnabled(true);
     submitButton->setText("Wyślij Odpowiedzi!");
-    inputCountry->clear();
+    clearAnswerInputs();
     if (roundResultsWidget) {
         roundResultsWidget->close();
         roundResultsWidget = nullptr;
@@ -409,274 +506,347 @@ void MainWindow::onDisconnected() {
     }
 }
 
-void MainWindow::onReadyRead() {
-    QByteArray data = socket->readAll();
-    incomingBuffer.append(data);
+void MainWindow::onNetEvents(const QVector<NetEvent> &events) {
+    pendingEvents += events;
+    if (applyingEvents) return;
+    applyingEvents = true;
+    // Handler moze otworzyc okno dialogowe, w ktorego petli przyjdzie
+    // kolejna paczka i powiekszy pendingEvents; stad kopia zdarzenia.
+    for (qsizetype i = 0; i < pendingEvents.size(); ++i) {
+        NetEvent event = pendingEvents[i];
+        applyEvent(event);
+    }
+    pendingEvents.clear();
+    applyingEvents = false;
+}
 
-    while (true) {
-        if (incomingBuffer.size() < (int)sizeof(MsgHeader)) break;
+// Komunikaty z obslugi zdarzen nie blokuja: exec() uruchomiloby petle
+// zdarzen wewnatrz applyEvent, a kolejne paczki (TIME_LEFT, zmiany etapu)
+// czekalyby w pendingEvents do zamkniecia okna.
+void MainWindow::showNotice(QMessageBox::Icon icon, const QString &title, const QString &text) {
+    auto *box = new QMessageBox(icon, title, text, QMessageBox::Ok, this);
+    box->setAttribute(Qt::WA_DeleteOnClose);
+    box->open();
+}
 
-        MsgHeader *header = reinterpret_cast<MsgHeader*>(incomingBuffer.data());
-        uint32_t len = ntohl(header->len);
+void MainWindow::applyEvent(const NetEvent &event) {
+    static constexpr MsgDispatcher<MessageHandler> dispatcher{
+        {MsgType::LOGIN_OK, &MainWindow::handleLoginOk},
+        {MsgType::LOGIN_FAIL, &MainWindow::handleLoginFail},
+        {MsgType::CREATE_ROOM_OK, &MainWindow::handleCreateRoomOk},
+        {MsgType::CREATE_ROOM_FAIL, &MainWindow::handleCreateRoomFail},
+        {MsgType::JOIN_ROOM_OK, &MainWindow::handleJoinRoomOk},
+        {MsgType::JOIN_ROOM_FAIL, &MainWindow::handleJoinRoomFail},
+        {MsgType::NEW_PLAYER_JOINED, &MainWindow::handleNewPlayerJoined},
+        {MsgType::PLAYER_LEFT, &MainWindow::handlePlayerLeft},
+        {MsgType::ROOM_LIST, &MainWindow::handleRoomList},
+        {MsgType::VERIFICATION_START, &MainWindow::handleVerificationStart},
+        {MsgType::GAME_STARTED, &MainWindow::handleGameStarted},
+        {MsgType::TIME_UP, &MainWindow::handleTimeUp},
+        {MsgType::TIME_LEFT, &MainWindow::handleTimeLeft},
+        {MsgType::ROUND_END, &MainWindow::handleRoundEnd},
+        {MsgType::GAME_END, &MainWindow::handleGameEnd},
+        {MsgType::LEADERBOARD, &MainWindow::handleLeaderboard},
+        {MsgType::GAME_START_FAIL, &MainWindow::handleGameStartFail},
+        {MsgType::SPECTATE_OK, &MainWindow::handleSpectateOk},
+        {MsgType::SPECTATE_FAIL, &MainWindow::handleSpectateFail},
+        {MsgType::HOST_LEFT, &MainWindow::handleHostLeft},
+        {MsgType::HOST_CHANGED, &MainWindow::handleHostChanged},
+        {MsgType::TOURNAMENT_QUEUED, &MainWindow::handleTournamentQueued},
+        {MsgType::TOURNAMENT_END, &MainWindow::handleTournamentEnd},
+        {MsgType::RESUME_OK, &MainWindow::handleResumeOk},
+        {MsgType::RESUME_FAIL, &MainWindow::handleResumeFail},
+    };
+
+    switch (event.kind) {
+    case NetEvent::Kind::CONNECTED:
+        onConnected();
+        return;
+    case NetEvent::Kind::DISCONNECTED:
+        onDisconnected();
+        return;
+    case NetEvent::Kind::SOCKET_ERROR:
+        onError(event.text);
+        return;
+    case NetEvent::Kind::MESSAGE:
+        break;
+    }
+    if (MessageHandler handler = dispatcher.find(event.type)) (this->*handler)(event);
+}
 
-        if (incomingBuffer.size() < (int)(sizeof(MsgHeader) + len)) break;
+void MainWindow::handleLoginOk(const NetEvent &event) {
+    resumeToken = event.text;
+    stackedWidget->setCurrentIndex(1);
+    log("Witaj w lobby: " + nickInput->text());
+    onRefreshRoomsClicked();
+}
 
-        std::vector<char> body;
-        if (len > 0) {
-            body.resize(len);
-            std::memcpy(body.data(), incomingBuffer.data() + sizeof(MsgHeader), len);
-        }
+void MainWindow::handleLoginFail(const NetEvent &event) {
+    showNotice(QMessageBox::Warning, "Błąd logowania", event.text);
+    QMetaObject::invokeMethod(worker, &NetWorker::disconnectFromHost, Qt::QueuedConnection);
+}
 
-        MsgHeader currentHeader = *header;
-        incomingBuffer.remove(0, sizeof(MsgHeader) + len);
-        processMessage(currentHeader, body);
-    }
-}
-
-void MainWindow::processMessage(MsgHeader header, const std::vector<char>& body) {
-    std::string msgData(body.begin(), body.end());
-    QString text = QString::fromStdString(msgData);
-
-    switch (header.type) {
-        case MsgType::LOGIN_OK:
-            stackedWidget->setCurrentIndex(1);
-            log("Witaj w lobby: " + nickInput->text());
-            onRefreshRoomsClicked();
-            break;
-            
-        case MsgType::LOGIN_FAIL:
-            QMessageBox::warning(this, "Błąd logowania", text);
-            socket->disconnectFromHost();
-            break;
-
-
-
-        case MsgType::CREATE_ROOM_OK:
-            stackedWidget->setCurrentIndex(2);
-            roomTitleLabel->setText("Pokój: " + text);
-            startGameButton->setEnabled(false);
-            playerList->clear();
-            playerList->addItem(nickInput->text() + " (Ty)");
-            log("Utworzono pokój.");
-            break;
-
-        case MsgType::CREATE_ROOM_FAIL:
-            QMessageBox::warning(this, "Błąd tworzenia pokoju", text);
-            break;
-
-        case MsgType::JOIN_ROOM_OK: {
-            stackedWidget->setCurrentIndex(2);
-            QStringList parts = text.split(";");
-            if (parts.size() >= 2) {
-                roomTitleLabel->setText("Pokój: " + parts[0]);
-                QStringList nicks = parts[1].split(",");
-                for (const QString &n : nicks) {
-                    if (n == nickInput->text()) {
-                        playerList->addItem(n + " (Ty)");
-                    } else {
-                        playerList->addItem(n);
-                    }
-                }
-            }
-            startGameButton->setEnabled(false);
-            log("Dołączono do pokoju.");
-            break;
-        }
-            
-        case MsgType::JOIN_ROOM_FAIL:
-            QMessageBox::warning(this, "Błąd", "Nie udało się dołączyć: " + text);
-            break;
-
-        case MsgType::NEW_PLAYER_JOINED:
-            playerList->addItem(text);
-            startGameButton->setEnabled(true);
-            log("Gracz dołączył: " + text);
-            break;
-
-        case MsgType::PLAYER_LEFT:
-            for (int i = 0; i < playerList->count(); ++i) {
-                if (playerList->item(i)->text().startsWith(text)) {
-                    delete playerList->takeItem(i);
-                    break;
-                }
-            }
-            log("Gracz opuścił: " + text);
-            break;
-
-        case MsgType::ROOM_LIST: {
-            roomList->clear();
-            QStringList rooms = text.split(";");
-            for (const QString &room : rooms) {
-                if (room.trimmed().isEmpty()) continue;
-
-                QStringList parts = room.split(":");
-                QString name;
-                QString state;
-                if (parts.size() >= 4) {
-                    name = parts[1];
-                    state = parts[3];
-                } else if (parts.size() >= 2) {
-                    name = parts[0];
-                    state = parts[1];
-                } else {
-                    name = room;
-                    state = "waiting";
-                }
-
-                QString stateText = (state == "inprogress" || state.toLower() == "inprogress") ? "In progress" : "Waiting";
-                QString display = name + " | " + stateText;
-                roomList->addItem(display);
-            }
-            break;
-        }
-        
-        case MsgType::VERIFICATION_START:
-            setupVerificationUI(text);
-            stackedWidget->setCurrentIndex(4);
-            submitVotesButton->setEnabled(true);
-            submitVotesButton->setText("Zatwierdź głosy");
-            break;
-
-        case MsgType::GAME_STARTED: {
-            QStringList parts = text.split(";");
-            if (parts.size() >= 3) {
-                QString letter = parts[0];
-                int current = parts[1].toInt();
-                int maxR = parts[2].toInt();
-                letterLabel->setText("Litera: " + letter);
-                roundLabel->setText("Runda: " + QString::number(current) + "/" + QString::number(maxR));
-                timeLeftLabel->setText("Czas: 30s");
-            }
-
-            if (roundResultsWidget) {
-                roundResultsWidget->close();
-                roundResultsWidget = nullptr;
-                roundResultsLabel = nullptr;
-            }
-            if (roundResultsBackdrop) {
-                roundResultsBackdrop->close();
-                roundResultsBackdrop = nullptr;
-            }
-            roundResultsTimer->stop();
-
-            inputCountry->clear();
-            inputCity->clear();
-            inputAnimal->clear();
-            inputPlant->clear();
-            inputObject->clear();
-            submitButton->setEnabled(true);
-            submitButton->setText("Wyślij Odpowiedzi!");
-
-            stackedWidget->setCurrentIndex(3);
-            break;
-        }
-            
-        case MsgType::TIME_UP:
-            onSubmitAnswersClicked();
-            break;
-            
-        case MsgType::TIME_LEFT:
-            timeLeftLabel->setText("Czas: " + QString::number(std::stoi(text.toStdString())) + "s");
-            break;
-            
-        case MsgType::ROUND_END: {
-            QStringList results = text.split(";");
-            QString message = "WYNIKI RUNDY:\n";
-            QString display = "";
-            for (const QString &r : results) {
-                if (r.trimmed().isEmpty()) continue;
-                QStringList kv = r.split(":");
-                if (kv.size() >= 2) {
-                    QString nick = kv[0];
-                    QString pts = kv[1];
-                    display += nick + ": " + pts + " pkt\n";
-                } else {
-                    display += r + "\n";
-                }
-            }
-
-            if (roundResultsWidget) {
-                roundResultsWidget->close();
-                roundResultsWidget = nullptr;
-                roundResultsLabel = nullptr;
-            }
-            if (roundResultsBackdrop) {
-                roundResultsBackdrop->close();
-                roundResultsBackdrop = nullptr;
-            }
-
-            roundResultsBackdrop = new QWidget(this);
-            roundResultsBackdrop->setAttribute(Qt::WA_DeleteOnClose);
-            roundResultsBackdrop->setWindowFlags(Qt::Tool | Qt::FramelessWindowHint | Qt::WindowStaysOnTopHint);
-            roundResultsBackdrop->setStyleSheet("background-color: rgba(0,0,0,160);");
-            roundResultsBackdrop->resize(this->size());
-            roundResultsBackdrop->move(0, 0);
-            roundResultsBackdrop->show();
-
-            roundResultsWidget = new QWidget(roundResultsBackdrop);
-            roundResultsWidget->setAttribute(Qt::WA_DeleteOnClose);
-            roundResultsWidget->setWindowFlags(Qt::Tool | Qt::FramelessWindowHint);
-            roundResultsWidget->setStyleSheet("background-color: rgba(40,40,40,240); border-radius: 10px;");
-            QVBoxLayout *v = new QVBoxLayout(roundResultsWidget);
-            roundResultsLabel = new QLabel(display, roundResultsWidget);
-            roundResultsLabel->setWordWrap(true);
-            roundResultsLabel->setAlignment(Qt::AlignCenter);
-            QFont f = roundResultsLabel->font();
-            f.setPointSize(qMax(14, f.pointSize() + 4));
-            f.setBold(true);
-            roundResultsLabel->setFont(f);
-            roundResultsLabel->setStyleSheet("color: white; padding: 16px;");
-            v->addWidget(roundResultsLabel);
-
-            QSize sz = roundResultsWidget->sizeHint();
-            int w = qMax(360, sz.width());
-            int h = qMax(120, sz.height());
-            roundResultsWidget->resize(w, h);
-            QPoint center = this->rect().center();
-            roundResultsWidget->move(center.x() - w/2, center.y() - h/2 - 30);
-            roundResultsWidget->show();
-
-            roundResultsTimer->start(5000);
-
-            stackedWidget->setCurrentIndex(2);
-            if (startGameButton->isEnabled() == false && roomTitleLabel->text().contains("ID:")) {
-                startGameButton->setEnabled(true);
-            }
-            break;
-        }
-            
-        case MsgType::GAME_END: {
-            QStringList results = text.split(";");
-            QString message = "KONIEC GRY - WYNIKI KOŃCOWE:\n";
-            for (const QString &r : results) {
-                if (!r.isEmpty()) message += r + " pkt\n";
-            }
-            if (roundResultsWidget) {
-                roundResultsWidget->close();
-                roundResultsWidget = nullptr;
-                roundResultsLabel = nullptr;
-            }
-            if (roundResultsBackdrop) {
-                roundResultsBackdrop->close();
-                roundResultsBackdrop = nullptr;
-            }
-            roundResultsTimer->stop();
-
-            finalScoreLabel->setText(message);
-            stackedWidget->setCurrentIndex(5);
-            finalScoreCountdown = 15;
-            finalScoreTimer->start(1000);
-            updateFinalScoreTimer();
-            break;
+void MainWindow::handleCreateRoomOk(const NetEvent &event) {
+    stackedWidget->setCurrentIndex(2);
+    roomTitleLabel->setText("Pokój: " + event.room);
+    roomHost = true;
+    startGameButton->setEnabled(false);
+    playerModel->setPlayers({nickInput->text()}, nickInput->text());
+    log("Utworzono pokój.");
+}
+
+void MainWindow::handleCreateRoomFail(const NetEvent &event) {
+    showNotice(QMessageBox::Warning, "Błąd tworzenia pokoju", event.text);
+}
+
+void MainWindow::handleJoinRoomOk(const NetEvent &event) {
+    // W turnieju serwer sadza gracza sam, rowniez prosto z ekranu wynikow.
+    finalScoreTimer->stop();
+    stackedWidget->setCurrentIndex(2);
+    if (!event.room.isEmpty()) {
+        roomTitleLabel->setText("Pokój: " + event.room);
+        playerModel->setPlayers(event.items, nickInput->text());
+    } else {
+        playerModel->clear();
+    }
+    roomHost = false;
+    startGameButton->setEnabled(false);
+    log("Dołączono do pokoju.");
+}
+
+void MainWindow::handleJoinRoomFail(const NetEvent &event) {
+    showNotice(QMessageBox::Warning, "Błąd", "Nie udało się dołączyć: " + event.text);
+}
+
+void MainWindow::handleNewPlayerJoined(const NetEvent &event) {
+    playerModel->add(event.text);
+    startGameButton->setEnabled(roomHost && !spectating);
+    log("Gracz dołączył: " + event.text);
+}
+
+void MainWindow::handlePlayerLeft(const NetEvent &event) {
+    playerModel->remove(event.text);
+    log("Gracz opuścił: " + event.text);
+}
+
+void MainWindow::handleRoomList(const NetEvent &event) {
+    roomModel->update(event.rooms);
+}
+
+void MainWindow::handleVerificationStart(const NetEvent &event) {
+    setupVerificationUI(event.categories);
+    stackedWidget->setCurrentIndex(4);
+    submitVotesButton->setEnabled(!spectating);
+    submitVotesButton->setText(spectating ? "Tryb obserwatora" : "Zatwierdź głosy");
+}
+
+void MainWindow::handleGameStarted(const NetEvent &event) {
+    if (!event.text.isEmpty()) {
+        letterLabel->setText("Litera: " + event.text);
+        roundLabel->setText("Runda: " + QString::number(event.round) + "/" + QString::number(event.maxRounds));
+        timeLeftLabel->setText("Czas: " + QString::number(event.number) + "s");
+    }
+    setupAnswerInputs(event.items);
+
+    if (roundResultsWidget) {
+        roundResultsWidget->close();
+        roundResultsWidget = nullptr;
+        roundResultsLabel = nullptr;
+    }
+    if (roundResultsBackdrop) {
+        roundResultsBackdrop->close();
+        roundResultsBackdrop = nullptr;
+    }
+    roundResultsTimer->stop();
+
+    submitButton->setEnabled(!spectating);
+    submitButton->setText(spectating ? "Tryb obserwatora" : "Wyślij Odpowiedzi!");
+
+    stackedWidget->setCurrentIndex(3);
+}
+
+void MainWindow::handleTimeUp(const NetEvent &) {
+    onSubmitAnswersClicked();
+}
+
+void MainWindow::handleTimeLeft(const NetEvent &event) {
+    timeLeftLabel->setText("Czas: " + QString::number(event.number) + "s");
+}
+
+void MainWindow::handleRoundEnd(const NetEvent &event) {
+    QString display = "";
+    for (const QStringList &kv : event.rows) {
+        if (kv.size() >= 2) {
+            display += kv[0] + ": " + kv[1] + " pkt\n";
+        } else {
+            display += kv[0] + "\n";
         }
-            
-        case MsgType::GAME_START_FAIL:
-            QMessageBox::warning(this, "Błąd startu", text);
-            break;
+    }
+
+    if (roundResultsWidget) {
+        roundResultsWidget->close();
+        roundResultsWidget = nullptr;
+        roundResultsLabel = nullptr;
+    }
+    if (roundResultsBackdrop) {
+        roundResultsBackdrop->close();
+        roundResultsBackdrop = nullptr;
+    }
+
+    roundResultsBackdrop = new QWidget(this);
+    roundResultsBackdrop->setAttribute(Qt::WA_DeleteOnClose);
+    roundResultsBackdrop->setWindowFlags(Qt::Tool | Qt::FramelessWindowHint | Qt::WindowStaysOnTopHint);
+    roundResultsBackdrop->setStyleSheet("background-color: rgba(0,0,0,160);");
+    roundResultsBackdrop->resize(this->size());
+    roundResultsBackdrop->move(0, 0);
+    roundResultsBackdrop->show();
+
+    roundResultsWidget = new QWidget(roundResultsBackdrop);
+    roundResultsWidget->setAttribute(Qt::WA_DeleteOnClose);
+    roundResultsWidget->setWindowFlags(Qt::Tool | Qt::FramelessWindowHint);
+    roundResultsWidget->setStyleSheet("background-color: rgba(40,40,40,240); border-radius: 10px;");
+    QVBoxLayout *v = new QVBoxLayout(roundResultsWidget);
+    roundResultsLabel = new QLabel(display, roundResultsWidget);
+    roundResultsLabel->setWordWrap(true);
+    roundResultsLabel->setAlignment(Qt::AlignCenter);
+    QFont f = roundResultsLabel->font();
+    f.setPointSize(qMax(14, f.pointSize() + 4));
+    f.setBold(true);
+    roundResultsLabel->setFont(f);
+    roundResultsLabel->setStyleSheet("color: white; padding: 16px;");
+    v->addWidget(roundResultsLabel);
+
+    QSize sz = roundResultsWidget->sizeHint();
+    int w = qMax(360, sz.width());
+    int h = qMax(120, sz.height());
+    roundResultsWidget->resize(w, h);
+    QPoint center = this->rect().center();
+    roundResultsWidget->move(center.x() - w/2, center.y() - h/2 - 30);
+    roundResultsWidget->show();
+
+    roundResultsTimer->start(5000);
+
+    stackedWidget->setCurrentIndex(2);
+    if (startGameButton->isEnabled() == false && roomTitleLabel->text().contains("ID:")) {
+        startGameButton->setEnabled(true);
+    }
+}
+
+void MainWindow::handleGameEnd(const NetEvent &event) {
+    QString message = "KONIEC GRY - WYNIKI KOŃCOWE:\n";
+    for (const QString &r : event.items) {
+        message += r + " pkt\n";
+    }
+    if (roundResultsWidget) {
+        roundResultsWidget->close();
+        roundResultsWidget = nullptr;
+        roundResultsLabel = nullptr;
+    }
+    if (roundResultsBackdrop) {
+        roundResultsBackdrop->close();
+        roundResultsBackdrop = nullptr;
+    }
+    roundResultsTimer->stop();
 
-        default:
-            break;
+    finalScoreLabel->setText(message);
+    stackedWidget->setCurrentIndex(5);
+    finalScoreCountdown = 15;
+    finalScoreTimer->start(1000);
+    updateFinalScoreTimer();
+}
+
+void MainWindow::handleLeaderboard(const NetEvent &event) {
+    QString message = "RANKING GRACZY:\n";
+    int place = 1;
+    for (const QStringList &parts : event.rows) {
+        if (parts.size() < 4) continue;
+        message += QString::number(place++) + ". " + parts[0] + " - " + parts[1] + " pkt, gier: "
+                 + parts[2] + ", unikalne: " + parts[3] + "%\n";
     }
+    if (place == 1) message += "Brak wynikow.";
+    showNotice(QMessageBox::Information, "Ranking", message);
+}
+
+void MainWindow::handleGameStartFail(const NetEvent &event) {
+    showNotice(QMessageBox::Warning, "Błąd startu", event.text);
+}
+
+void MainWindow::handleSpectateOk(const NetEvent &event) {
+    spectating = true;
+    stackedWidget->setCurrentIndex(2);
+    if (!event.room.isEmpty()) {
+        roomTitleLabel->setText("Pokój: " + event.room + " (obserwator)");
+        playerModel->setPlayers(event.items);
+    } else {
+        playerModel->clear();
+    }
+    startGameButton->setEnabled(false);
+    log("Obserwujesz pokój.");
+}
+
+void MainWindow::handleSpectateFail(const NetEvent &event) {
+    showNotice(QMessageBox::Warning, "Błąd", "Nie udało się obserwować: " + event.text);
+}
+
+void MainWindow::handleHostLeft(const NetEvent &) {
+    if (stackedWidget->currentIndex() < 2) return;
+    goToLobby();
+    showNotice(QMessageBox::Information, "Pokój zamknięty", "Host opuścił pokój.");
+}
+
+// Starsze serwery zamykaly pokoj (HOST_LEFT); teraz gospodarzem zostaje
+// kolejny gracz, a gra toczy sie dalej.
+void MainWindow::handleHostChanged(const NetEvent &event) {
+    bool nowHost = !spectating && event.text == nickInput->text();
+    if (nowHost && !roomHost) log("Jesteś teraz hostem pokoju.");
+    else if (!nowHost) log("Nowy host pokoju: " + event.text);
+    roomHost = nowHost;
+    startGameButton->setEnabled(roomHost && stackedWidget->currentIndex() == 2 && playerModel->rowCount() >= 2);
+}
+
+void MainWindow::handleTournamentQueued(const NetEvent &event) {
+    if (event.number == 0) {
+        log("Awans do kolejnego etapu turnieju!");
+    } else {
+        log("Zapisano do turnieju. Oczekujących graczy: " + QString::number(event.number));
+    }
+}
+
+void MainWindow::handleTournamentEnd(const NetEvent &event) {
+    QString message = "Zwycięzca turnieju: " + (event.text.isEmpty() ? QString("brak") : event.text)
+                    + "\nEtapów: " + QString::number(event.number) + "\n\nKlasyfikacja:\n";
+    for (const QString &entry : event.items) {
+        message += entry + " pkt\n";
+    }
+    showNotice(QMessageBox::Information, "Koniec turnieju", message);
+}
+
+// "nick;pokoj;gracz,gracz,..."; jesli trwa runda, serwer dosyla zaraz
+// GAME_STARTED albo VERIFICATION_START.
+void MainWindow::handleResumeOk(const NetEvent &event) {
+    reconnecting = false;
+    reconnectAttempts = 0;
+    if (event.room.isEmpty()) {
+        goToLobby();
+        log("Wznowiono sesję.");
+        onRefreshRoomsClicked();
+        return;
+    }
+    closeRoundResults();
+    stackedWidget->setCurrentIndex(2);
+    roomTitleLabel->setText("Pokój: " + event.room);
+    playerModel->setPlayers(event.items, event.text);
+    // Kto jest hostem, serwer podaje zaraz potem w HOST_CHANGED.
+    roomHost = false;
+    startGameButton->setEnabled(false);
+    log("Wznowiono sesję.");
+}
+
+void MainWindow::handleResumeFail(const NetEvent &event) {
+    resumeToken.clear();
+    resetToLoginPage();
+    showNotice(QMessageBox::Warning, "Rozłączono", "Nie udało się wznowić gry: " + event.text);
+    QMetaObject::invokeMethod(worker, &NetWorker::disconnectFromHost, Qt::QueuedConnection);
 }
 
 void MainWindow::closeRoundResults() {
@@ -1,17 +1,22 @@
 #pragma once
 #include <QMainWindow>
-#include <QTcpSocket>
+#include <QThread>
 #include <QLineEdit>
 #include <QTextEdit>
 #include <QPushButton>
 #include <QStackedWidget>
 #include <QLabel>
-#include <QListWidget>
-#include <QScrollArea>
-#include <QCheckBox>
+#include <QListView>
 #include <QVBoxLayout>
 #include <QTimer>
+#include <QComboBox>
+#include <QFormLayout>
 #include "../common/protocol.hpp"
+#include "../common/rules.hpp"
+#include "../common/compression.hpp"
+#include "net_worker.hpp"
+#include "verification_model.hpp"
+#include "lobby_models.hpp"
 #include <QMessageBox>
 
 class MainWindow : public QMainWindow {
@@ -24,24 +29,38 @@ public:
 private slots:
     void onConnectClicked();
         void onConnectTimeout();
-    void onReadyRead();
-    void onConnected();
-    void onDisconnected();
-    void onError(QAbstractSocket::SocketError);
+    void onNetEvents(const QVector<NetEvent> &events);
+    void attemptReconnect();
 
     void onCreateRoomClicked();
     void onJoinRoomClicked();
+    void onSpectateRoomClicked();
     void onStartGameClicked();
     void onLeaveRoomClicked();
     void onSubmitAnswersClicked();
     void onSubmitVotesClicked();
     void onRefreshRoomsClicked();
+    void onLeaderboardClicked();
+    void onTournamentJoinClicked();
     void goToLobby();
     void updateFinalScoreTimer();
 
 private:
-    QTcpSocket *socket;
-    QByteArray incomingBuffer;
+    // Gniazdo i dekodowanie ramek sa w watku netThread; okno dostaje
+    // gotowe zdarzenia, a wysyla przez sendMessage.
+    QThread *netThread;
+    NetWorker *worker;
+    // Paczki, ktore przyszly w trakcie obslugi poprzedniej (gdyby handler
+    // uruchomil zagniezdzona petle zdarzen), czekaja tu, zeby zachowac
+    // kolejnosc. Dlatego handlery pokazuja komunikaty przez showNotice.
+    QVector<NetEvent> pendingEvents;
+    bool applyingEvents = false;
+    void applyEvent(const NetEvent &event);
+    void showNotice(QMessageBox::Icon icon, const QString &title, const QString &text);
+    void sendMessage(MsgType type, const std::string &data, bool acceptCompressed = false);
+    void onConnected();
+    void onDisconnected();
+    void onError(const QString &error);
 
     QStackedWidget *stackedWidget;
 
@@ -53,14 +72,21 @@ private:
 
     QWidget *lobbyPage;
     QLineEdit *roomNameInput;
+    QComboBox *rulesCombo;
     QLineEdit *roomNameInputJoin;
-    QListWidget *roomList;
+    QListView *roomList;
+    RoomListModel *roomModel;
     QPushButton *refreshButton;
+    QPushButton *leaderboardButton;
+    QPushButton *tournamentButton;
     QTextEdit *lobbyLog;
+    bool spectating = false;
+    bool roomHost = false;
 
     QWidget *roomPage;
     QLabel *roomTitleLabel;
-    QListWidget *playerList;
+    QListView *playerList;
+    PlayerListModel *playerModel;
     QPushButton *startGameButton;
     QPushButton *leaveRoomButton;
     QTextEdit *gameLog;
@@ -69,17 +95,20 @@ private:
     QLabel *letterLabel;
     QLabel *roundLabel;
     QLabel *timeLeftLabel;
-    QLineEdit *inputCountry;
-    QLineEdit *inputCity;
-    QLineEdit *inputAnimal;
-    QLineEdit *inputPlant;
-    QLineEdit *inputObject;
+    QFormLayout *answerForm;
+    std::vector<QLineEdit*> answerInputs;
+    QStringList answerCategories;
     QPushButton *submitButton;
     
     QWidget *verifyPage;
     QVBoxLayout *verifyLayoutContainer; 
     QPushButton *submitVotesButton;
-    std::vector<std::pair<int, QCheckBox*>> voteCheckboxes; 
+    struct VerifySection {
+        QLabel *label;
+        QListView *view;
+        VerificationModel *model;
+    };
+    QVector<VerifySection> verifySections;
 
     QWidget *finalScorePage;
     QLabel *finalScoreLabel;
@@ -88,10 +117,47 @@ private:
     int finalScoreCountdown;
 
         QTimer *connectTimer;
+
+    // Wznawianie sesji po zerwaniu polaczenia (token z LOGIN_OK).
+    QString serverHost;
+    quint16 serverPort = 0;
+    QString resumeToken;
+    QTimer *reconnectTimer;
+    int reconnectAttempts = 0;
+    bool reconnecting = false;
+    void scheduleReconnect();
+    void resetToLoginPage();
     void setupUI();
-    void processMessage(MsgHeader header, const std::vector<char>& body);
+    using MessageHandler = void (MainWindow::*)(const NetEvent &);
+    void handleLoginOk(const NetEvent &event);
+    void handleLoginFail(const NetEvent &event);
+    void handleCreateRoomOk(const NetEvent &event);
+    void handleCreateRoomFail(const NetEvent &event);
+    void handleJoinRoomOk(const NetEvent &event);
+    void handleJoinRoomFail(const NetEvent &event);
+    void handleNewPlayerJoined(const NetEvent &event);
+    void handlePlayerLeft(const NetEvent &event);
+    void handleRoomList(const NetEvent &event);
+    void handleVerificationStart(const NetEvent &event);
+    void handleGameStarted(const NetEvent &event);
+    void handleTimeUp(const NetEvent &event);
+    void handleTimeLeft(const NetEvent &event);
+    void handleRoundEnd(const NetEvent &event);
+    void handleGameEnd(const NetEvent &event);
+    void handleLeaderboard(const NetEvent &event);
+    void handleGameStartFail(const NetEvent &event);
+    void handleSpectateOk(const NetEvent &event);
+    void handleSpectateFail(const NetEvent &event);
+    void handleHostLeft(const NetEvent &event);
+    void handleHostChanged(const NetEvent &event);
+    void handleTournamentQueued(const NetEvent &event);
+    void handleTournamentEnd(const NetEvent &event);
+    void handleResumeOk(const NetEvent &event);
+    void handleResumeFail(const NetEvent &event);
     void log(const QString &msg);
-    void setupVerificationUI(const QString &data);
+    void setupVerificationUI(const QVector<VerificationCategory> &categories);
+    void setupAnswerInputs(const QStringList &categories);
+    void clearAnswerInputs();
     void closeRoundResults();
     QWidget *roundResultsWidget;
     QLabel *roundResultsLabel;
@@ -0,0 +1,192 @@
+#include "net_worker.hpp"
+#include "../common/messages.hpp"
+
+namespace {
+
+QString toQString(std::string_view text) {
+    return QString::fromUtf8(text.data(), static_cast<qsizetype>(text.size()));
+}
+
+QStringList toQStringList(const std::vector<std::string_view> &items) {
+    QStringList out;
+    for (std::string_view item : items) out.append(toQString(item));
+    return out;
+}
+
+QStringList nonEmpty(const QStringList &list) {
+    QStringList out;
+    for (const QString &s : list) {
+        if (!s.trimmed().isEmpty()) out.append(s);
+    }
+    return out;
+}
+
+// Tresc jest rozkladana wspolnymi dekoderami z messages.hpp prosto z bufora
+// GameClient; na QString zamieniane sa dopiero gotowe pola.
+bool decodeMessage(MsgType type, std::string_view body, NetEvent &event) {
+    event.type = type;
+    switch (type) {
+    case MsgType::TIME_LEFT:
+    case MsgType::TOURNAMENT_QUEUED:
+        event.number = decodeNumber(body);
+        return true;
+    case MsgType::ROOM_LIST:
+        for (const RoomListEntryView &room : decodeRoomList(body)) {
+            RoomEntry entry;
+            entry.name = toQString(room.name);
+            entry.inProgress = room.inProgress;
+            event.rooms.append(entry);
+        }
+        return true;
+    case MsgType::VERIFICATION_START:
+        for (const VerificationCategoryView &view : decodeVerification(body)) {
+            VerificationCategory category;
+            category.name = toQString(view.name);
+            category.answers = toQStringList(view.answers);
+            category.verdicts = QString::fromUtf8(view.verdicts.data(), static_cast<qsizetype>(view.verdicts.size()));
+            event.categories.append(category);
+        }
+        return true;
+    case MsgType::CREATE_ROOM_OK:
+        event.room = toQString(body);
+        return true;
+    case MsgType::JOIN_ROOM_OK:
+    case MsgType::SPECTATE_OK: {
+        RoomMembersView view = decodeRoomMembers(body);
+        event.room = toQString(view.room);
+        event.items = nonEmpty(toQStringList(view.players));
+        return true;
+    }
+    case MsgType::RESUME_OK: {
+        ResumeOkView view = decodeResumeOk(body);
+        event.text = toQString(view.nick);
+        event.room = toQString(view.room);
+        event.items = nonEmpty(toQStringList(view.players));
+        return true;
+    }
+    case MsgType::GAME_STARTED: {
+        GameStartedView view = decodeGameStarted(body);
+        if (view.fields >= 3) {
+            event.text = toQString(view.letter);
+            event.round = view.round;
+            event.maxRounds = view.maxRounds;
+        }
+        event.number = view.fields >= 4 ? view.seconds : 30;
+        event.items = view.fields >= 5 ? toQStringList(view.categories)
+                                       : QStringList{"Panstwo", "Miasto", "Zwierze", "Roslina", "Rzecz"};
+        return true;
+    }
+    case MsgType::ROUND_END:
+    case MsgType::LEADERBOARD:
+        for (const auto &row : decodeRows(body)) event.rows.append(toQStringList(row));
+        return true;
+    case MsgType::GAME_END:
+        event.items = nonEmpty(toQStringList(splitFields(body, ';', true)));
+        return true;
+    case MsgType::TOURNAMENT_END: {
+        TournamentEndView view = decodeTournamentEnd(body);
+        if (!view.valid) return false;
+        event.text = toQString(view.winner);
+        event.number = view.stages;
+        event.items = toQStringList(view.standings);
+        return true;
+    }
+    default:
+        event.text = toQString(body);
+        return true;
+    }
+}
+
+}
+
+NetWorker::NetWorker(QObject *parent) : QObject(parent) {}
+
+void NetWorker::start() {
+    socket = new QTcpSocket(this);
+    flushTimer = new QTimer(this);
+    flushTimer->setSingleShot(true);
+
+    client.setHandler([this](GameClient &, const GameClient::Event &message) {
+        NetEvent event;
+        if (decodeMessage(message.type, message.body, event)) push(std::move(event));
+    });
+
+    connect(flushTimer, &QTimer::timeout, this, &NetWorker::flush);
+    connect(socket, &QTcpSocket::readyRead, this, &NetWorker::onReadyRead);
+    connect(socket, &QTcpSocket::connected, this, [this] {
+        client.connected();
+        NetEvent event;
+        event.kind = NetEvent::Kind::CONNECTED;
+        push(event);
+    });
+    connect(socket, &QTcpSocket::disconnected, this, [this] {
+        client.disconnected();
+        NetEvent event;
+        event.kind = NetEvent::Kind::DISCONNECTED;
+        push(event);
+    });
+    connect(socket, &QTcpSocket::errorOccurred, this, [this](QAbstractSocket::SocketError) {
+        NetEvent event;
+        event.kind = NetEvent::Kind::SOCKET_ERROR;
+        event.text = socket->errorString();
+        push(event);
+    });
+}
+
+void NetWorker::connectToHost(const QString &host, quint16 port) {
+    socket->abort();
+    client.disconnected();
+    socket->connectToHost(host, port);
+}
+
+void NetWorker::abort() {
+    socket->abort();
+    client.disconnected();
+}
+
+void NetWorker::disconnectFromHost() {
+    socket->disconnectFromHost();
+}
+
+void NetWorker::send(MsgType type, const QByteArray &payload, bool acceptCompressed) {
+    client.send(type, std::string_view(payload.constData(), payload.size()), acceptCompressed);
+    flushOutput();
+}
+
+void NetWorker::flushOutput() {
+    std::string_view out = client.pendingOutput();
+    if (out.empty()) return;
+    socket->write(out.data(), static_cast<qint64>(out.size()));
+    client.consumeOutput(out.size());
+}
+
+void NetWorker::onReadyRead() {
+    qint64 available = socket->bytesAvailable();
+    if (available <= 0) return;
+    char *buffer = client.prepareInput(available);
+    qint64 n = socket->read(buffer, available);
+    if (n <= 0) return;
+    if (!client.commitInput(n)) {
+        abort();
+        return;
+    }
+    flushOutput();
+}
+
+void NetWorker::push(NetEvent event) {
+    bool coalesce = event.kind == NetEvent::Kind::MESSAGE && event.type == MsgType::TIME_LEFT && !pending.isEmpty()
+                 && pending.back().kind == NetEvent::Kind::MESSAGE && pending.back().type == MsgType::TIME_LEFT;
+    if (coalesce) {
+        pending.back().number = event.number;
+    } else {
+        pending.append(std::move(event));
+    }
+    if (!flushTimer->isActive()) flushTimer->start(kFlushMs);
+}
+
+void NetWorker::flush() {
+    if (pending.isEmpty()) return;
+    QVector<NetEvent> batch;
+    batch.swap(pending);
+    emit eventsReady(batch);
+}
@@ -0,0 +1,82 @@
+#pragma once
+#include <QObject>
+#include <QTcpSocket>
+#include <QTimer>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <QMetaType>
+#include "../common/protocol.hpp"
+#include "../client_core/game_client.hpp"
+
+struct RoomEntry {
+    QString name;
+    bool inProgress = false;
+};
+
+struct VerificationCategory {
+    QString name;
+    QStringList answers;
+    QString verdicts;  // '+', '-' albo '?' na odpowiedz; pusty, gdy serwer nic nie zna
+};
+
+// Zdarzenie z watku sieci, juz rozlozone na pola; ktore pola sa wypelnione,
+// zalezy od typu wiadomosci.
+struct NetEvent {
+    enum class Kind {
+        MESSAGE,
+        CONNECTED,
+        DISCONNECTED,
+        SOCKET_ERROR
+    };
+
+    Kind kind = Kind::MESSAGE;
+    MsgType type = MsgType::LOGIN_OK;
+    QString text;                  // nick, token, litera, komunikat bledu
+    QString room;                  // nazwa pokoju
+    QStringList items;             // nicki w pokoju, kategorie rundy, wyniki koncowe
+    QVector<QStringList> rows;     // ROUND_END, LEADERBOARD: wpisy rozbite na pola
+    QVector<RoomEntry> rooms;      // ROOM_LIST
+    QVector<VerificationCategory> categories;  // VERIFICATION_START
+    int number = 0;                // sekundy, liczba oczekujacych, etapy turnieju
+    int round = 0;
+    int maxRounds = 0;
+};
+
+Q_DECLARE_METATYPE(NetEvent)
+
+// Gniazdo zyje w osobnym watku razem z GameClient, ktory ramkuje ruch i
+// odpowiada na PING bez udzialu watku GUI. Zdarzenia zbierane sa w paczke
+// i wysylane do okna raz na klatke (kFlushMs), a z kilku TIME_LEFT pod
+// rzad w paczce zostaje tylko ostatni.
+class NetWorker : public QObject {
+    Q_OBJECT
+
+public:
+    static constexpr int kFlushMs = 16;
+
+    explicit NetWorker(QObject *parent = nullptr);
+
+    // Wywolywane w watku sieci (QMetaObject::invokeMethod).
+    void send(MsgType type, const QByteArray &payload, bool acceptCompressed);
+
+public slots:
+    void start();
+    void connectToHost(const QString &host, quint16 port);
+    void abort();
+    void disconnectFromHost();
+
+signals:
+    void eventsReady(const QVector<NetEvent> &events);
+
+private:
+    QTcpSocket *socket = nullptr;
+    QTimer *flushTimer = nullptr;
+    GameClient client;
+    QVector<NetEvent> pending;
+
+    void onReadyRead();
+    void flushOutput();
+    void push(NetEvent event);
+    void flush();
+};
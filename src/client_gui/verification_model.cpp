@@ -0,0 +1,61 @@
+#include "verification_model.hpp"
+
+VerificationModel::VerificationModel(QObject *parent) : QAbstractListModel(parent) {}
+
+void VerificationModel::reset(const VerificationCategory &newCategory) {
+    beginResetModel();
+    category = newCategory;
+    vetoed.assign(category.answers.size(), false);
+    // Odpowiedz odrzucona przez serwer jest pokazywana jako zaznaczona.
+    for (int i = 0; i < category.answers.size(); ++i) vetoed[i] = verdictAt(i) == '-';
+    endResetModel();
+}
+
+void VerificationModel::clear() {
+    reset(VerificationCategory());
+}
+
+char VerificationModel::verdictAt(int row) const {
+    return row < category.verdicts.size() ? category.verdicts[row].toLatin1() : '?';
+}
+
+// '+'/'-' to werdykt serwera z poprzednich gier, na takie odpowiedzi sie
+// nie glosuje.
+bool VerificationModel::isKnown(int row) const {
+    char verdict = verdictAt(row);
+    return verdict == '+' || verdict == '-';
+}
+
+int VerificationModel::rowCount(const QModelIndex &parent) const {
+    return parent.isValid() ? 0 : static_cast<int>(category.answers.size());
+}
+
+QVariant VerificationModel::data(const QModelIndex &index, int role) const {
+    if (!index.isValid() || index.row() >= rowCount()) return QVariant();
+    int row = index.row();
+    switch (role) {
+    case Qt::DisplayRole: {
+        char verdict = verdictAt(row);
+        if (verdict == '+') return category.answers[row] + " (zaakceptowana)";
+        if (verdict == '-') return category.answers[row] + " (odrzucona)";
+        return category.answers[row];
+    }
+    case Qt::CheckStateRole:
+        return vetoed[row] ? Qt::Checked : Qt::Unchecked;
+    default:
+        return QVariant();
+    }
+}
+
+bool VerificationModel::setData(const QModelIndex &index, const QVariant &value, int role) {
+    if (role != Qt::CheckStateRole || !index.isValid() || isKnown(index.row())) return false;
+    vetoed[index.row()] = value.toInt() == Qt::Checked;
+    emit dataChanged(index, index, {Qt::CheckStateRole});
+    return true;
+}
+
+Qt::ItemFlags VerificationModel::flags(const QModelIndex &index) const {
+    if (!index.isValid()) return Qt::NoItemFlags;
+    if (isKnown(index.row())) return Qt::ItemNeverHasChildren;
+    return Qt::ItemIsEnabled | Qt::ItemIsUserCheckable | Qt::ItemNeverHasChildren;
+}
@@ -0,0 +1,39 @@
+#pragma once
+#include <QAbstractListModel>
+#include <QString>
+#include <vector>
+#include "net_worker.hpp"
+
+// Odpowiedzi jednej kategorii na ekranie weryfikacji. Widok (QListView)
+// rysuje tylko widoczne wiersze zwyklym delegatem z polem wyboru, wiec
+// nawet tysiace odpowiedzi nie tworza zadnych widgetow. Model zyje miedzy
+// rundami; nowa runda podmienia tylko dane (reset).
+class VerificationModel : public QAbstractListModel {
+    Q_OBJECT
+
+public:
+    explicit VerificationModel(QObject *parent = nullptr);
+
+    void reset(const VerificationCategory &category);
+    void clear();
+
+    // Odpowiedzi zaznaczone jako bledne, bez tych z werdyktem serwera.
+    template <typename Fn>
+    void forEachVeto(Fn &&fn) const {
+        for (size_t i = 0; i < vetoed.size(); ++i) {
+            if (vetoed[i] && !isKnown(static_cast<int>(i))) fn(category.answers[i]);
+        }
+    }
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    bool setData(const QModelIndex &index, const QVariant &value, int role) override;
+    Qt::ItemFlags flags(const QModelIndex &index) const override;
+
+private:
+    VerificationCategory category;
+    std::vector<bool> vetoed;
+
+    char verdictAt(int row) const;
+    bool isKnown(int row) const;
+};
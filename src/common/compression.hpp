@@ -0,0 +1,149 @@
+#pragma once
+#include <zlib.h>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "protocol.hpp"
+
+// Kompresja duzych ramek od serwera (deflate ze wspolnym slownikiem).
+// Tresc skompresowanej ramki: uint32 (kolejnosc sieciowa) z dlugoscia
+// oryginalu, a za nim surowy strumien deflate. Naglowek ma ustawiony
+// kFrameFlagCompressed. Serwer wysyla je tylko klientom, ktorzy ustawili
+// te flage w LOGIN, i tylko gdy tresc ma co najmniej kCompressionThreshold
+// bajtow i po kompresji jest krotsza.
+
+constexpr size_t kCompressionThreshold = 512;
+
+// Slownik ze slowami i separatorami, ktore najczesciej pojawiaja sie w
+// listach pokoi, weryfikacji i wynikach. Najczestsze fragmenty sa na koncu,
+// bo deflate najtaniej odwoluje sie do najblizszych bajtow.
+inline std::string_view compressionDictionary() {
+    static const char dictionary[] =
+        "AustriaAngliaAlbaniaAmsterdamAtenyAntylopaArbuzAgrestAparatAuto"
+        "BelgiaBrazyliaBerlinBrukselaBialystokBobrBawolBananBrzozaButelkaBalon"
+        "ChinyChorwacjaCzechyChicagoCzestochowaChomikCebulaCytrynaCukierek"
+        "DaniaDublinDelfinDzikDyniaDabDrzwiDlugopis"
+        "EgiptEstoniaEdynburgEmuEukaliptusEkran"
+        "FrancjaFinlandiaFlorencjaFokaFasolaFigaFotel"
+        "GrecjaGdanskGdyniaGenuaGorylGepardGruszkaGrochGitaraGarnek"
+        "HiszpaniaHolandiaHelsinkiHienaHipopotamHiacyntHerbata"
+        "IndieIrlandiaIslandiaItaliaIndykIrysIgla"
+        "JaponiaJemenJerozolimaJastrzabJezJabloJarzebinaJacht"
+        "KanadaKeniaKrakowKatowiceKielceKotKrowaKaczkaKoziolKapustaKalafiorKrzesloKlucz"
+        "LitwaLotwaLondynLizbonaLublinLodzLewLisLamaLilakLampaLyzka"
+        "MeksykMaltaMadrytMoskwaMediolanMalpaMrowkaMarchewMalinaMlotek"
+        "NiemcyNorwegiaNepalNeapolNowy JorkNosorozecNietoperzNarcyzNozNozyczki"
+        "OmanOsloOlsztynOpoleOstrowOselOrzelOcelotOgorekOlchaOkno"
+        "PolskaPortugaliaPeruParyzPragaPoznanPekinPiesPapugaPanteraPingwin"
+        "PomidorPietruszkaPaprocPorPilkaPatelniaParasolPedzel"
+        "RosjaRumuniaRzymRadomRzeszowRybaRysRenRzodkiewkaRozaRadio"
+        "SzwecjaSzwajcariaSlowacjaSzczecinSopotSlonSowaSarnaSlonecznikSosnaStolSamochod"
+        "TurcjaTajlandiaTokioTorunTarnowTygrysTchorzTulipanTruskawkaTelefonTalerz"
+        "UkrainaUrugwajUstkaUdonUlmaUrnaUkulele"
+        "WegryWlochyWarszawaWroclawWiedenWilnoWilkWiewiorkaWaz"
+        "ZambiaZakopaneZamoscZyrafaZebraZajacZiemniakZurawinaZegarZeszyt"
+        ":inprogress;:waiting;Pokoj Turniej :0:0;:5;:10;:15;:20;"
+        "Imie:Zawod:Rzeka:Kolor:Potrawa:"
+        "Panstwo:Miasto:Zwierze:Roslina:Rzecz:";
+    return std::string_view(dictionary, sizeof(dictionary) - 1);
+}
+
+// Strumienie zlib sa drogie w inicjalizacji, wiec kazdy watek trzyma po
+// jednym i tylko je resetuje.
+class FrameDeflater {
+public:
+    FrameDeflater() {
+        std::memset(&stream, 0, sizeof(stream));
+        // Przy ramkach rzedu kilku KB wyzsze poziomy daja podobny rozmiar,
+        // a sa 2-5x wolniejsze (server_bench compress_*).
+        ok = deflateInit2(&stream, Z_BEST_SPEED, Z_DEFLATED, -15, 8, Z_DEFAULT_STRATEGY) == Z_OK;
+    }
+    ~FrameDeflater() {
+        if (ok) deflateEnd(&stream);
+    }
+    FrameDeflater(const FrameDeflater&) = delete;
+    FrameDeflater& operator=(const FrameDeflater&) = delete;
+
+    // Dopisuje surowy strumien deflate do out; false przy bledzie.
+    bool compress(std::string_view data, std::vector<char>& out) {
+        if (!ok || deflateReset(&stream) != Z_OK) return false;
+        auto dict = compressionDictionary();
+        deflateSetDictionary(&stream, reinterpret_cast<const Bytef*>(dict.data()), dict.size());
+
+        size_t start = out.size();
+        out.resize(start + deflateBound(&stream, data.size()));
+        stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data.data()));
+        stream.avail_in = data.size();
+        stream.next_out = reinterpret_cast<Bytef*>(out.data() + start);
+        stream.avail_out = out.size() - start;
+        if (deflate(&stream, Z_FINISH) != Z_STREAM_END) return false;
+        out.resize(out.size() - stream.avail_out);
+        return true;
+    }
+
+private:
+    z_stream stream;
+    bool ok = false;
+};
+
+class FrameInflater {
+public:
+    FrameInflater() {
+        std::memset(&stream, 0, sizeof(stream));
+        ok = inflateInit2(&stream, -15) == Z_OK;
+    }
+    ~FrameInflater() {
+        if (ok) inflateEnd(&stream);
+    }
+    FrameInflater(const FrameInflater&) = delete;
+    FrameInflater& operator=(const FrameInflater&) = delete;
+
+    bool decompress(std::string_view data, size_t rawLen, std::string& out) {
+        if (!ok || inflateReset(&stream) != Z_OK) return false;
+        auto dict = compressionDictionary();
+        inflateSetDictionary(&stream, reinterpret_cast<const Bytef*>(dict.data()), dict.size());
+
+        out.resize(rawLen);
+        stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data.data()));
+        stream.avail_in = data.size();
+        stream.next_out = reinterpret_cast<Bytef*>(out.data());
+        stream.avail_out = rawLen;
+        return inflate(&stream, Z_FINISH) == Z_STREAM_END && stream.avail_out == 0 && stream.avail_in == 0;
+    }
+
+private:
+    z_stream stream;
+    bool ok = false;
+};
+
+// Buduje skompresowana ramke. Zwraca false, gdy kompresja sie nie oplaca
+// i nalezy wyslac zwykla ramke z createMessage.
+inline bool compressFrame(MsgType type, std::string_view data, std::vector<char>& frame) {
+    if (data.size() < kCompressionThreshold) return false;
+    thread_local FrameDeflater deflater;
+
+    frame.resize(sizeof(MsgHeader) + sizeof(uint32_t));
+    uint32_t rawLen = htonl(data.size());
+    std::memcpy(frame.data() + sizeof(MsgHeader), &rawLen, sizeof(rawLen));
+    if (!deflater.compress(data, frame) || frame.size() >= sizeof(MsgHeader) + data.size()) return false;
+
+    MsgHeader header;
+    header.type = static_cast<MsgType>(static_cast<uint8_t>(type) | kFrameFlagCompressed);
+    header.len = htonl(frame.size() - sizeof(MsgHeader));
+    std::memcpy(frame.data(), &header, sizeof(header));
+    return true;
+}
+
+// Rozpakowuje tresc ramki z kFrameFlagCompressed. Dlugosc oryginalu jest
+// sprawdzana z limitem typu przed alokacja.
+inline bool decompressPayload(MsgType type, std::string_view body, std::string& out) {
+    if (body.size() < sizeof(uint32_t)) return false;
+    uint32_t rawLen;
+    std::memcpy(&rawLen, body.data(), sizeof(rawLen));
+    rawLen = ntohl(rawLen);
+    if (rawLen > msgSpec(frameType(type)).maxLen) return false;
+
+    thread_local FrameInflater inflater;
+    return inflater.decompress(body.substr(sizeof(uint32_t)), rawLen, out);
+}
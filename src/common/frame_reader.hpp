@@ -0,0 +1,93 @@
+#pragma once
+#include <algorithm>
+#include <cstring>
+#include <string_view>
+#include <vector>
+#include "protocol.hpp"
+
+// Bufor odbiorczy wspolny dla serwera i klienta GUI. Dane z gniazda sa
+// czytane wprost na koniec bufora (prepare/commit), a ramki wydawane jako
+// widoki na tresc, bez kopiowania. Przetworzone bajty sa tylko przeskakiwane
+// kursorem; reszta wraca na poczatek bufora dopiero przy kolejnym zapisie i
+// tylko gdy kursor minal polowe, wiec kazdy bajt jest przesuwany najwyzej
+// raz. Widok tresci jest wazny do nastepnego prepare/append.
+
+class FrameReader {
+public:
+    enum class Status {
+        FRAME,
+        NEED_MORE,
+        INVALID  // naglowek z nieznanym typem, zlym kierunkiem albo za dlugi
+    };
+
+    // Miejsce na co najmniej n bajtow; po odczycie z gniazda trzeba wywolac commit.
+    char* prepare(size_t n) {
+        compact();
+        if (buffer.size() < end + n) buffer.resize(std::max(end + n, buffer.size() * 2));
+        return buffer.data() + end;
+    }
+
+    void commit(size_t n) {
+        end += n;
+    }
+
+    void append(const char* data, size_t n) {
+        std::memcpy(prepare(n), data, n);
+        commit(n);
+    }
+
+    Status next(uint8_t direction, MsgHeader& header, std::string_view& body) {
+        if (end - cursor < sizeof(MsgHeader)) return Status::NEED_MORE;
+        std::memcpy(&header, buffer.data() + cursor, sizeof(header));
+        if (!isAcceptedHeader(header, direction)) return Status::INVALID;
+        uint32_t len = ntohl(header.len);
+        if (end - cursor - sizeof(MsgHeader) < len) return Status::NEED_MORE;
+
+        body = std::string_view(buffer.data() + cursor + sizeof(MsgHeader), len);
+        cursor += sizeof(MsgHeader) + len;
+        return Status::FRAME;
+    }
+
+    size_t buffered() const {
+        return end - cursor;
+    }
+
+    size_t capacity() const {
+        return buffer.size();
+    }
+
+    void clear() {
+        cursor = end = 0;
+    }
+
+    // Zmniejsza bufor do max(bytes, buffered()) bajtow, np. po jednorazowo
+    // duzej ramce; nieprzetworzone dane przechodza na poczatek.
+    void shrink(size_t bytes) {
+        std::vector<char> smaller(std::max(bytes, end - cursor));
+        std::memcpy(smaller.data(), buffer.data() + cursor, end - cursor);
+        end -= cursor;
+        cursor = 0;
+        buffer.swap(smaller);
+    }
+
+    // Oddaje pamiec bufora (np. dla sesji bez polaczenia).
+    void release() {
+        std::vector<char>().swap(buffer);
+        clear();
+    }
+
+private:
+    std::vector<char> buffer;  // size() to pojemnosc, dane leza w [cursor, end)
+    size_t cursor = 0;
+    size_t end = 0;
+
+    void compact() {
+        if (cursor == end) {
+            clear();
+        } else if (cursor >= buffer.size() / 2) {
+            std::memmove(buffer.data(), buffer.data() + cursor, end - cursor);
+            end -= cursor;
+            cursor = 0;
+        }
+    }
+};
@@ -0,0 +1,235 @@
+#pragma once
+#include <algorithm>
+#include <charconv>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "protocol.hpp"
+
+// Typowane widoki tresci wiadomosci, wspolne dla serwera, GameClient i okna
+// Qt. Dekodery nie kopiuja tekstu: pola sa string_view do ciala ramki, wiec
+// widok zyje tyle co ramka. Ramke sprawdza wczesniej isValidPayload; tu
+// brakujace pola zostaja puste albo zerowe.
+
+// Pola rozdzielone sep; z skipEmpty puste pola sa pomijane.
+inline std::vector<std::string_view> splitFields(std::string_view text, char sep, bool skipEmpty = false) {
+    std::vector<std::string_view> out;
+    size_t start = 0;
+    while (start <= text.size()) {
+        size_t end = text.find(sep, start);
+        if (end == std::string_view::npos) end = text.size();
+        if (!skipEmpty || end > start) out.push_back(text.substr(start, end - start));
+        start = end + 1;
+    }
+    return out;
+}
+
+inline int decodeNumber(std::string_view body) {
+    int value = 0;
+    std::from_chars(body.data(), body.data() + body.size(), value);
+    return value;
+}
+
+// --- od klienta ---
+
+// CREATE_ROOM: "nazwa" albo "nazwa;zestaw_zasad".
+struct CreateRoomView {
+    std::string_view name;
+    std::string_view rulesId;
+    bool hasRules = false;
+};
+
+inline CreateRoomView decodeCreateRoom(std::string_view body) {
+    CreateRoomView view;
+    size_t sep = body.rfind(';');
+    view.name = body.substr(0, sep);
+    if (sep != std::string_view::npos) {
+        view.rulesId = body.substr(sep + 1);
+        view.hasRules = true;
+    }
+    return view;
+}
+
+// GET_LEADERBOARD: liczba wierszy 1..100, domyslnie 10.
+inline size_t decodeLeaderboardRequest(std::string_view body) {
+    if (body.empty()) return 10;
+    size_t count = 0;
+    for (char c : body) count = std::min<size_t>(100, count * 10 + (c - '0'));
+    return std::max<size_t>(1, count);
+}
+
+// RESUME: 16 cyfr szesnastkowych; 0 dla niepoprawnego tokenu.
+inline uint64_t decodeResumeToken(std::string_view body) {
+    if (body.size() != kResumeTokenLen) return 0;
+    uint64_t token = 0;
+    for (char c : body) {
+        int digit;
+        if (c >= '0' && c <= '9') digit = c - '0';
+        else if (c >= 'a' && c <= 'f') digit = c - 'a' + 10;
+        else return 0;
+        token = (token << 4) | digit;
+    }
+    return token;
+}
+
+// SEND_VOTE: "kategoria:odpowiedz;..."; fn(kategoria, odpowiedz) dla kazdego
+// poprawnego glosu przeciw.
+template <typename Fn>
+void forEachVote(std::string_view body, Fn&& fn) {
+    for (std::string_view part : splitFields(body, ';', true)) {
+        size_t colon = part.find(':');
+        if (colon == std::string_view::npos || part.find(':', colon + 1) != std::string_view::npos) continue;
+        std::string_view index = part.substr(0, colon);
+        std::string_view answer = part.substr(colon + 1);
+        size_t category = 0;
+        auto [end, ec] = std::from_chars(index.data(), index.data() + index.size(), category);
+        if (ec != std::errc() || end != index.data() + index.size() || answer.empty()) continue;
+        fn(category, answer);
+    }
+}
+
+// --- od serwera ---
+
+// RESUME_OK: "nick;pokoj;gracz,gracz,...".
+struct ResumeOkView {
+    std::string_view nick;
+    std::string_view room;
+    std::vector<std::string_view> players;
+};
+
+inline ResumeOkView decodeResumeOk(std::string_view body) {
+    auto parts = splitFields(body, ';');
+    ResumeOkView view;
+    view.nick = parts[0];
+    if (parts.size() >= 3) {
+        view.room = parts[1];
+        view.players = splitFields(parts[2], ',', true);
+    }
+    return view;
+}
+
+// JOIN_ROOM_OK, SPECTATE_OK: "pokoj;gracz,gracz,...".
+struct RoomMembersView {
+    std::string_view room;
+    std::vector<std::string_view> players;
+};
+
+inline RoomMembersView decodeRoomMembers(std::string_view body) {
+    auto parts = splitFields(body, ';');
+    RoomMembersView view;
+    view.room = parts[0];
+    if (parts.size() >= 2) view.players = splitFields(parts[1], ',', true);
+    return view;
+}
+
+// GAME_STARTED: "litera;runda;rundy;sekundy;kategoria,kategoria,...";
+// fields mowi, ile pol przyszlo (starsze serwery nie wysylaly dwoch
+// ostatnich).
+struct GameStartedView {
+    size_t fields = 0;
+    std::string_view letter;
+    int round = 0;
+    int maxRounds = 0;
+    int seconds = 0;
+    std::vector<std::string_view> categories;
+};
+
+inline GameStartedView decodeGameStarted(std::string_view body) {
+    auto parts = splitFields(body, ';');
+    GameStartedView view;
+    view.fields = parts.size();
+    view.letter = parts[0];
+    if (parts.size() >= 3) {
+        view.round = decodeNumber(parts[1]);
+        view.maxRounds = decodeNumber(parts[2]);
+    }
+    if (parts.size() >= 4) view.seconds = decodeNumber(parts[3]);
+    if (parts.size() >= 5) view.categories = splitFields(parts[4], ',');
+    return view;
+}
+
+// VERIFICATION_START: "kategoria:odp,odp[:werdykty];...". Werdykty ida po
+// pozycjach odpowiedzi; puste odpowiedzi sa pomijane razem ze swoim znakiem,
+// a gdy zaden werdykt nie jest znany, verdicts jest pusty.
+struct VerificationCategoryView {
+    std::string_view name;
+    std::vector<std::string_view> answers;
+    std::string verdicts;
+};
+
+inline std::vector<VerificationCategoryView> decodeVerification(std::string_view body) {
+    std::vector<VerificationCategoryView> categories;
+    for (std::string_view entry : splitFields(body, ';', true)) {
+        auto parts = splitFields(entry, ':');
+        if (parts.size() < 2) continue;
+        VerificationCategoryView category;
+        category.name = parts[0];
+        std::string_view verdicts = parts.size() >= 3 ? parts[2] : std::string_view();
+        auto answers = splitFields(parts[1], ',');
+        for (size_t i = 0; i < answers.size(); ++i) {
+            if (answers[i].empty()) continue;
+            category.verdicts += i < verdicts.size() ? verdicts[i] : '?';
+            category.answers.push_back(answers[i]);
+        }
+        if (category.verdicts.find_first_not_of('?') == std::string::npos) category.verdicts.clear();
+        categories.push_back(std::move(category));
+    }
+    return categories;
+}
+
+// ROOM_LIST: "id:nazwa:gracze:stan;" albo starsze "nazwa:stan;".
+struct RoomListEntryView {
+    std::string_view name;
+    bool inProgress = false;
+};
+
+inline std::vector<RoomListEntryView> decodeRoomList(std::string_view body) {
+    std::vector<RoomListEntryView> rooms;
+    for (std::string_view room : splitFields(body, ';', true)) {
+        auto parts = splitFields(room, ':');
+        RoomListEntryView entry;
+        std::string_view state = "waiting";
+        if (parts.size() >= 4) {
+            entry.name = parts[1];
+            state = parts[3];
+        } else if (parts.size() >= 2) {
+            entry.name = parts[0];
+            state = parts[1];
+        } else {
+            entry.name = room;
+        }
+        entry.inProgress = state.size() == 10 && std::equal(state.begin(), state.end(), "inprogress",
+                                                            [](char a, char b) { return (a | 0x20) == b; });
+        rooms.push_back(entry);
+    }
+    return rooms;
+}
+
+// ROUND_END, LEADERBOARD: "pole:pole:...;" - wiersze rozbite na pola.
+inline std::vector<std::vector<std::string_view>> decodeRows(std::string_view body) {
+    std::vector<std::vector<std::string_view>> rows;
+    for (std::string_view row : splitFields(body, ';', true)) rows.push_back(splitFields(row, ':'));
+    return rows;
+}
+
+// TOURNAMENT_END: "zwyciezca;etapy;nick:punkty;...".
+struct TournamentEndView {
+    bool valid = false;
+    std::string_view winner;
+    int stages = 0;
+    std::vector<std::string_view> standings;
+};
+
+inline TournamentEndView decodeTournamentEnd(std::string_view body) {
+    auto parts = splitFields(body, ';');
+    TournamentEndView view;
+    if (parts.size() < 2) return view;
+    view.valid = true;
+    view.winner = parts[0];
+    view.stages = decodeNumber(parts[1]);
+    for (size_t i = 2; i < parts.size(); ++i) {
+        if (!parts[i].empty()) view.standings.push_back(parts[i]);
+    }
+    return view;
+}
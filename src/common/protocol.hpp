@@ -3,6 +3,9 @@
 #include <vector>
 #include <string>
 #include <cstring>
+#include <array>
+#include <string_view>
+#include <initializer_list>
 #include <arpa/inet.h>
 
 enum class MsgType : uint8_t {
@@ -33,9 +36,44 @@ enum class MsgType : uint8_t {
     ROUND_END,
     LEAVE_ROOM,
     HOST_LEFT,
-    GAME_END 
+    GAME_END,
+
+    GET_LEADERBOARD,
+    LEADERBOARD,
+
+    SPECTATE_ROOM,
+    SPECTATE_OK,
+    SPECTATE_FAIL,
+
+    TOURNAMENT_JOIN,
+    TOURNAMENT_QUEUED,
+    TOURNAMENT_END,
+
+    PING,
+    PONG,
+
+    RESUME,
+    RESUME_OK,
+    RESUME_FAIL,
+
+    HOST_CHANGED
 };
 
+constexpr size_t kMsgTypeCount = static_cast<size_t>(MsgType::HOST_CHANGED) + 1;
+
+// Najwyzszy bit typu to flaga ramki. W ramce od serwera oznacza skompresowana
+// tresc (compression.hpp), w LOGIN i RESUME od klienta - ze klient umie je
+// odczytac.
+constexpr uint8_t kFrameFlagCompressed = 0x80;
+
+constexpr MsgType frameType(MsgType raw) {
+    return static_cast<MsgType>(static_cast<uint8_t>(raw) & ~kFrameFlagCompressed);
+}
+
+constexpr bool hasCompressedFlag(MsgType raw) {
+    return (static_cast<uint8_t>(raw) & kFrameFlagCompressed) != 0;
+}
+
 struct MsgHeader {
     MsgType type;
     uint32_t len; 
@@ -52,3 +90,179 @@ inline std::vector<char> createMessage(MsgType type, const std::string& data) {
     std::memcpy(buffer.data() + sizeof(MsgHeader), data.data(), data.size());
     return buffer;
 }
+
+enum MsgDirection : uint8_t {
+    MSG_TO_SERVER = 1,
+    MSG_TO_CLIENT = 2
+};
+
+enum class PayloadKind : uint8_t {
+    NONE,
+    NUMBER,
+    TEXT,
+    LIST
+};
+
+struct MsgSpec {
+    uint8_t direction;
+    PayloadKind payload;
+    uint32_t maxLen;
+};
+
+constexpr uint32_t kMaxNameLen = 64;
+constexpr uint32_t kMaxRulesIdLen = 32;
+constexpr uint32_t kMaxAnswersLen = 2048;
+constexpr uint32_t kMaxVotesLen = 64 * 1024;
+constexpr uint32_t kMaxServerPayload = 16 * 1024 * 1024;
+// Token wznowienia sesji z LOGIN_OK: 64 bity zapisane szesnastkowo.
+constexpr uint32_t kResumeTokenLen = 16;
+
+// Odpowiedzi ida w SUBMIT_ANSWERS rozdzielone ';', a w VERIFICATION_START
+// i SEND_VOTE takze ':' i ','; zadnego z tych znakow nie ma w odpowiedzi.
+constexpr std::string_view kAnswerSeparators = ";:,";
+
+inline bool hasAnswerSeparator(std::string_view answer) {
+    return answer.find_first_of(kAnswerSeparators) != std::string_view::npos;
+}
+
+constexpr MsgSpec msgSpec(MsgType type) {
+    switch (type) {
+        case MsgType::LOGIN:              return {MSG_TO_SERVER, PayloadKind::TEXT, kMaxNameLen};
+        case MsgType::LOGIN_OK:           return {MSG_TO_CLIENT, PayloadKind::TEXT, kMaxServerPayload};
+        case MsgType::LOGIN_FAIL:         return {MSG_TO_CLIENT, PayloadKind::TEXT, kMaxServerPayload};
+        case MsgType::CREATE_ROOM:        return {MSG_TO_SERVER, PayloadKind::TEXT, kMaxNameLen + 1 + kMaxRulesIdLen};
+        case MsgType::CREATE_ROOM_OK:     return {MSG_TO_CLIENT, PayloadKind::TEXT, kMaxServerPayload};
+        case MsgType::CREATE_ROOM_FAIL:   return {MSG_TO_CLIENT, PayloadKind::TEXT, kMaxServerPayload};
+        case MsgType::GET_ROOM_LIST:      return {MSG_TO_SERVER, PayloadKind::NONE, 0};
+        case MsgType::ROOM_LIST:          return {MSG_TO_CLIENT, PayloadKind::LIST, kMaxServerPayload};
+        case MsgType::JOIN_ROOM:          return {MSG_TO_SERVER, PayloadKind::TEXT, kMaxNameLen};
+        case MsgType::JOIN_ROOM_OK:       return {MSG_TO_CLIENT, PayloadKind::LIST, kMaxServerPayload};
+        case MsgType::JOIN_ROOM_FAIL:     return {MSG_TO_CLIENT, PayloadKind::TEXT, kMaxServerPayload};
+        case MsgType::NEW_PLAYER_JOINED:  return {MSG_TO_CLIENT, PayloadKind::TEXT, kMaxServerPayload};
+        case MsgType::PLAYER_LEFT:        return {MSG_TO_CLIENT, PayloadKind::TEXT, kMaxServerPayload};
+        case MsgType::START_GAME:         return {MSG_TO_SERVER, PayloadKind::NONE, 0};
+        case MsgType::GAME_STARTED:       return {MSG_TO_CLIENT, PayloadKind::LIST, kMaxServerPayload};
+        case MsgType::GAME_START_FAIL:    return {MSG_TO_CLIENT, PayloadKind::TEXT, kMaxServerPayload};
+        case MsgType::SUBMIT_ANSWERS:     return {MSG_TO_SERVER, PayloadKind::LIST, kMaxAnswersLen};
+        case MsgType::VERIFICATION_START: return {MSG_TO_CLIENT, PayloadKind::LIST, kMaxServerPayload};
+        case MsgType::TIME_UP:            return {MSG_TO_CLIENT, PayloadKind::NONE, 0};
+        case MsgType::TIME_LEFT:          return {MSG_TO_CLIENT, PayloadKind::NUMBER, 16};
+        case MsgType::SEND_VOTE:          return {MSG_TO_SERVER, PayloadKind::LIST, kMaxVotesLen};
+        case MsgType::ROUND_END:          return {MSG_TO_CLIENT, PayloadKind::LIST, kMaxServerPayload};
+        case MsgType::LEAVE_ROOM:         return {MSG_TO_SERVER, PayloadKind::NONE, 0};
+        case MsgType::HOST_LEFT:          return {MSG_TO_CLIENT, PayloadKind::NONE, 0};
+        case MsgType::GAME_END:           return {MSG_TO_CLIENT, PayloadKind::LIST, kMaxServerPayload};
+        case MsgType::GET_LEADERBOARD:    return {MSG_TO_SERVER, PayloadKind::NUMBER, 3};
+        case MsgType::LEADERBOARD:        return {MSG_TO_CLIENT, PayloadKind::LIST, kMaxServerPayload};
+        case MsgType::SPECTATE_ROOM:      return {MSG_TO_SERVER, PayloadKind::TEXT, kMaxNameLen};
+        case MsgType::SPECTATE_OK:        return {MSG_TO_CLIENT, PayloadKind::LIST, kMaxServerPayload};
+        case MsgType::SPECTATE_FAIL:      return {MSG_TO_CLIENT, PayloadKind::TEXT, kMaxServerPayload};
+        case MsgType::TOURNAMENT_JOIN:    return {MSG_TO_SERVER, PayloadKind::NONE, 0};
+        case MsgType::TOURNAMENT_QUEUED:  return {MSG_TO_CLIENT, PayloadKind::NUMBER, 16};
+        case MsgType::TOURNAMENT_END:     return {MSG_TO_CLIENT, PayloadKind::LIST, kMaxServerPayload};
+        case MsgType::PING:               return {MSG_TO_SERVER | MSG_TO_CLIENT, PayloadKind::NONE, 0};
+        case MsgType::PONG:               return {MSG_TO_SERVER | MSG_TO_CLIENT, PayloadKind::NONE, 0};
+        case MsgType::RESUME:             return {MSG_TO_SERVER, PayloadKind::TEXT, kResumeTokenLen};
+        case MsgType::RESUME_OK:          return {MSG_TO_CLIENT, PayloadKind::LIST, kMaxServerPayload};
+        case MsgType::RESUME_FAIL:        return {MSG_TO_CLIENT, PayloadKind::TEXT, kMaxServerPayload};
+        case MsgType::HOST_CHANGED:       return {MSG_TO_CLIENT, PayloadKind::TEXT, kMaxServerPayload};
+    }
+    return {0, PayloadKind::NONE, 0};
+}
+
+// Nazwa typu do logow i sladow wykonania.
+constexpr const char* msgTypeName(MsgType type) {
+    switch (type) {
+        case MsgType::LOGIN:              return "LOGIN";
+        case MsgType::LOGIN_OK:           return "LOGIN_OK";
+        case MsgType::LOGIN_FAIL:         return "LOGIN_FAIL";
+        case MsgType::CREATE_ROOM:        return "CREATE_ROOM";
+        case MsgType::CREATE_ROOM_OK:     return "CREATE_ROOM_OK";
+        case MsgType::CREATE_ROOM_FAIL:   return "CREATE_ROOM_FAIL";
+        case MsgType::GET_ROOM_LIST:      return "GET_ROOM_LIST";
+        case MsgType::ROOM_LIST:          return "ROOM_LIST";
+        case MsgType::JOIN_ROOM:          return "JOIN_ROOM";
+        case MsgType::JOIN_ROOM_OK:       return "JOIN_ROOM_OK";
+        case MsgType::JOIN_ROOM_FAIL:     return "JOIN_ROOM_FAIL";
+        case MsgType::NEW_PLAYER_JOINED:  return "NEW_PLAYER_JOINED";
+        case MsgType::PLAYER_LEFT:        return "PLAYER_LEFT";
+        case MsgType::START_GAME:         return "START_GAME";
+        case MsgType::GAME_STARTED:       return "GAME_STARTED";
+        case MsgType::GAME_START_FAIL:    return "GAME_START_FAIL";
+        case MsgType::SUBMIT_ANSWERS:     return "SUBMIT_ANSWERS";
+        case MsgType::VERIFICATION_START: return "VERIFICATION_START";
+        case MsgType::TIME_UP:            return "TIME_UP";
+        case MsgType::TIME_LEFT:          return "TIME_LEFT";
+        case MsgType::SEND_VOTE:          return "SEND_VOTE";
+        case MsgType::ROUND_END:          return "ROUND_END";
+        case MsgType::LEAVE_ROOM:         return "LEAVE_ROOM";
+        case MsgType::HOST_LEFT:          return "HOST_LEFT";
+        case MsgType::GAME_END:           return "GAME_END";
+        case MsgType::GET_LEADERBOARD:    return "GET_LEADERBOARD";
+        case MsgType::LEADERBOARD:        return "LEADERBOARD";
+        case MsgType::SPECTATE_ROOM:      return "SPECTATE_ROOM";
+        case MsgType::SPECTATE_OK:        return "SPECTATE_OK";
+        case MsgType::SPECTATE_FAIL:      return "SPECTATE_FAIL";
+        case MsgType::TOURNAMENT_JOIN:    return "TOURNAMENT_JOIN";
+        case MsgType::TOURNAMENT_QUEUED:  return "TOURNAMENT_QUEUED";
+        case MsgType::TOURNAMENT_END:     return "TOURNAMENT_END";
+        case MsgType::PING:               return "PING";
+        case MsgType::PONG:               return "PONG";
+        case MsgType::RESUME:             return "RESUME";
+        case MsgType::RESUME_OK:          return "RESUME_OK";
+        case MsgType::RESUME_FAIL:        return "RESUME_FAIL";
+        case MsgType::HOST_CHANGED:       return "HOST_CHANGED";
+    }
+    return "UNKNOWN";
+}
+
+constexpr bool isAcceptedHeader(const MsgHeader& header, uint8_t direction) {
+    MsgType type = frameType(header.type);
+    MsgSpec spec = msgSpec(type);
+    if (hasCompressedFlag(header.type)) {
+        bool allowed = direction == MSG_TO_SERVER ? (type == MsgType::LOGIN || type == MsgType::RESUME) : spec.maxLen == kMaxServerPayload;
+        if (!allowed) return false;
+    }
+    return (spec.direction & direction) != 0 && ntohl(header.len) <= spec.maxLen;
+}
+
+inline bool isValidPayload(MsgType type, std::string_view payload) {
+    switch (msgSpec(type).payload) {
+        case PayloadKind::NONE:
+            return payload.empty();
+        case PayloadKind::NUMBER:
+            for (char c : payload) {
+                if (c < '0' || c > '9') return false;
+            }
+            return true;
+        case PayloadKind::TEXT:
+            return !payload.empty() && payload.find('\0') == std::string_view::npos;
+        case PayloadKind::LIST:
+            return payload.find('\0') == std::string_view::npos;
+    }
+    return false;
+}
+
+// Tablica obslugi wiadomosci budowana w czasie kompilacji, indeksowana typem.
+// Fn to wskaznik na metode; brak wpisu oznacza nullptr.
+template <typename Fn>
+class MsgDispatcher {
+public:
+    struct Entry {
+        MsgType type;
+        Fn handler;
+    };
+
+    constexpr MsgDispatcher(std::initializer_list<Entry> entries) : table{} {
+        for (const Entry& e : entries) {
+            table[static_cast<uint8_t>(e.type)] = e.handler;
+        }
+    }
+
+    constexpr Fn find(MsgType type) const {
+        return table[static_cast<uint8_t>(type)];
+    }
+
+private:
+    std::array<Fn, 256> table;
+};
@@ -0,0 +1,57 @@
+#pragma once
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Zestawy zasad wybierane przy tworzeniu pokoju. Pokoj trzyma wskaznik na
+// gotowy zestaw, wiec w trakcie gry nie ma wyszukiwania po nazwie; kategorie
+// sa indeksowane numerem, a lista dla GAME_STARTED jest sklejona z gory.
+
+struct RuleSet {
+    std::string id;
+    std::vector<std::string> categories;
+    int maxRounds = 3;
+    int answerSeconds = 30;
+    int voteSeconds = 30;
+    int intermissionSeconds = 5;
+    int uniquePoints = 10;
+    int sharedPoints = 5;
+    std::string categoryList;
+
+    RuleSet(std::string id, std::vector<std::string> categories, int maxRounds,
+            int answerSeconds, int voteSeconds, int intermissionSeconds, int uniquePoints, int sharedPoints)
+        : id(std::move(id)), categories(std::move(categories)), maxRounds(maxRounds),
+          answerSeconds(answerSeconds), voteSeconds(voteSeconds), intermissionSeconds(intermissionSeconds),
+          uniquePoints(uniquePoints), sharedPoints(sharedPoints) {
+        for (const auto& name : this->categories) {
+            if (!categoryList.empty()) categoryList += ",";
+            categoryList += name;
+        }
+    }
+
+    size_t categoryCount() const {
+        return categories.size();
+    }
+};
+
+inline const std::vector<RuleSet>& rulePresets() {
+    static const std::vector<RuleSet> presets = {
+        {"klasyczne", {"Panstwo", "Miasto", "Zwierze", "Roslina", "Rzecz"}, 3, 30, 30, 5, 10, 5},
+        {"szybkie", {"Panstwo", "Miasto", "Zwierze", "Roslina", "Rzecz"}, 5, 20, 20, 3, 10, 5},
+        {"rozszerzone", {"Panstwo", "Miasto", "Zwierze", "Roslina", "Rzecz",
+                         "Imie", "Zawod", "Rzeka", "Kolor", "Potrawa"}, 3, 60, 45, 5, 10, 5},
+        {"krotkie", {"Panstwo", "Miasto", "Zwierze"}, 3, 15, 15, 3, 10, 5},
+    };
+    return presets;
+}
+
+inline const RuleSet& defaultRules() {
+    return rulePresets().front();
+}
+
+inline const RuleSet* findRules(std::string_view id) {
+    for (const auto& rules : rulePresets()) {
+        if (rules.id == id) return &rules;
+    }
+    return nullptr;
+}
@@ -0,0 +1,322 @@
+#pragma once
+#include <algorithm>
+#include <ctime>
+#include <map>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <sstream>
+#include "rate_limiter.hpp"
+#include "rules.hpp"
+#include "letter_draw.hpp"
+#include "frame_reader.hpp"
+#include "messages.hpp"
+#include "memory_usage.hpp"
+
+// Logika gry niezalezna od gniazd: uzywana przez GameServer oraz server_bench.
+
+// Klient odlaczony z zachowana sesja zostaje w GameServer::clients pod
+// ujemnym kluczem (fd < -1) do czasu wznowienia albo wygasniecia sesji.
+struct Client {
+    int fd = -1;
+    std::string nick;
+    FrameReader reader;
+    int currentRoomId = -1;
+    int spectatingRoomId = -1;
+    bool acceptsCompressed = false;
+    time_t connectedAt = 0;
+    time_t lastActivity = 0;
+    time_t idleCheckAt = 0;
+    bool pingSent = false;
+    uint64_t resumeToken = 0;
+    time_t detachedAt = 0;
+    int score = 0;
+    int answersGiven = 0;
+    int uniqueAnswers = 0;
+    ClientRateState rate;
+};
+
+// Przebieg gry w pokoju: LOBBY -> (ANSWERING -> VERIFYING -> INTERMISSION)*
+// -> koniec gry. Przejscia robi GameServer::enterPhase, terminy faz trafiaja
+// do wspolnej kolejki TimerQueue.
+enum class RoomPhase : uint8_t {
+    LOBBY,
+    ANSWERING,
+    VERIFYING,
+    INTERMISSION
+};
+
+struct Room {
+    int id;
+    std::string name;
+    int hostFd;
+    std::vector<int> players;
+    std::vector<int> spectators;
+    RoomPhase phase = RoomPhase::LOBBY;
+    time_t phaseDeadline = 0;
+    uint32_t timerGeneration = 0;
+    bool tournament = false;
+    std::string roundInfo;
+    std::string verificationInfo;
+    char letter = 0;
+
+    std::map<int, std::string> playerAnswers;
+    std::map<int, std::string> playerVotes;
+    // Odpowiedzi ocenione z gory przez pamiec werdyktow (kategoria -> slowo -> przyjeta).
+    std::vector<std::unordered_map<std::string, bool>> knownVerdicts;
+
+    int currentRound = 0;
+    const RuleSet* rules = &defaultRules();
+    LetterDraw letters;
+
+    bool gameStarted() const {
+        return phase != RoomPhase::LOBBY;
+    }
+};
+
+// Pamiec klienta razem z wezlem w GameServer::clients.
+inline size_t clientBytes(const Client& client) {
+    return kNodeOverhead + sizeof(std::pair<const int, Client>) + heapBytes(client.nick) + client.reader.capacity();
+}
+
+inline size_t answerMapBytes(const std::map<int, std::string>& answers) {
+    size_t bytes = 0;
+    for (const auto& [pid, text] : answers) bytes += kNodeOverhead + sizeof(std::pair<const int, std::string>) + heapBytes(text);
+    return bytes;
+}
+
+inline size_t knownVerdictBytes(const Room& room) {
+    size_t bytes = heapBytes(room.knownVerdicts);
+    for (const auto& category : room.knownVerdicts) {
+        bytes += category.bucket_count() * sizeof(void*);
+        for (const auto& [word, accepted] : category) {
+            bytes += kNodeOverhead + sizeof(std::pair<const std::string, bool>) + heapBytes(word);
+        }
+    }
+    return bytes;
+}
+
+inline size_t roomBytes(const Room& room) {
+    return kNodeOverhead + sizeof(std::pair<const int, Room>) + heapBytes(room.name) + heapBytes(room.players)
+         + heapBytes(room.spectators) + heapBytes(room.roundInfo) + heapBytes(room.verificationInfo)
+         + answerMapBytes(room.playerAnswers) + answerMapBytes(room.playerVotes) + knownVerdictBytes(room);
+}
+
+struct RoundScore {
+    int points = 0;
+    int accepted = 0;
+    int unique = 0;
+};
+
+inline std::vector<std::string> split(const std::string& s, char delimiter) {
+    std::vector<std::string> tokens;
+    std::string token;
+    std::istringstream tokenStream(s);
+    while (std::getline(tokenStream, token, delimiter)) {
+        tokens.push_back(token);
+    }
+    return tokens;
+}
+
+// Odpowiedz z ':' albo ',' rozbilaby VERIFICATION_START i glosy, wiec liczy
+// sie jak pusta. Liczba pol (kategorii) sie nie zmienia.
+inline std::string sanitizeAnswers(std::string_view data) {
+    std::string out;
+    size_t start = 0;
+    while (true) {
+        size_t end = data.find(';', start);
+        std::string_view part = data.substr(start, end == std::string_view::npos ? end : end - start);
+        if (!hasAnswerSeparator(part)) out += part;
+        if (end == std::string_view::npos) break;
+        out += ';';
+        start = end + 1;
+    }
+    return out;
+}
+
+inline std::string buildRoomList(const std::map<int, Room>& rooms) {
+    std::string list;
+    for (const auto& [id, room] : rooms) {
+        std::string state = room.gameStarted() ? "inprogress" : "waiting";
+        list += std::to_string(id) + ":" + room.name + ":" + std::to_string(room.players.size()) + ":" + state + ";";
+    }
+    return list;
+}
+
+// Rozne odpowiedzi w kazdej kategorii, posortowane.
+inline std::vector<std::set<std::string>> collectAnswers(const RuleSet& rules, const std::map<int, std::string>& playerAnswers) {
+    const size_t categoryCount = rules.categoryCount();
+    std::vector<std::set<std::string>> cats(categoryCount);
+
+    for (auto const& [pid, ansStr] : playerAnswers) {
+        auto parts = split(ansStr, ';');
+        for (size_t i=0; i<parts.size() && i<categoryCount; ++i) {
+            if (!parts[i].empty()) {
+                cats[i].insert(parts[i]);
+            }
+        }
+    }
+    return cats;
+}
+
+// "Kategoria:odp,odp,...;" dla kazdej kategorii. Jesli czesc odpowiedzi ma
+// werdykt z pamieci, po drugim dwukropku idzie po jednym znaku na odpowiedz:
+// '+' przyjeta, '-' odrzucona, '?' do glosowania. Starsi klienci ten fragment
+// pomijaja.
+inline std::string buildVerificationPayload(const RuleSet& rules, const std::vector<std::set<std::string>>& cats,
+                                            const std::vector<std::unordered_map<std::string, bool>>& known) {
+    std::string payload = "";
+
+    for (size_t i=0; i<cats.size(); ++i) {
+        payload += rules.categories[i] + ":";
+        std::string marks;
+        bool anyKnown = false;
+        bool first = true;
+        for (const auto& ans : cats[i]) {
+            if (!first) payload += ",";
+            payload += ans;
+            first = false;
+
+            char mark = '?';
+            if (i < known.size()) {
+                auto it = known[i].find(ans);
+                if (it != known[i].end()) {
+                    mark = it->second ? '+' : '-';
+                    anyKnown = true;
+                }
+            }
+            marks += mark;
+        }
+        if (anyKnown) payload += ":" + marks;
+        payload += ";";
+    }
+    return payload;
+}
+
+inline std::string buildVerificationPayload(const RuleSet& rules, const std::map<int, std::string>& playerAnswers) {
+    return buildVerificationPayload(rules, collectAnswers(rules, playerAnswers), {});
+}
+
+// Odpowiedz odpada, gdy co najmniej polowa glosujacych uznala ja za bledna,
+// ale tylko jesli glosowala co najmniej polowa graczy (kworum). Bez kworum,
+// np. po uplywie czasu na glosowanie, wszystkie odpowiedzi sa uznawane.
+// Gdy glosowali wszyscy, regula jest taka sama jak dawne
+// votesAgainst * 2 < totalPlayers.
+inline bool isAnswerAccepted(int votesAgainst, int voters, int totalPlayers) {
+    if (totalPlayers <= 1) return true;
+    if (voters * 2 < totalPlayers) return true;
+    return votesAgainst * 2 < voters;
+}
+
+// Liczba glosow przeciw kazdej odpowiedzi, w podziale na kategorie.
+inline std::vector<std::unordered_map<std::string, int>> countVetos(const Room& room) {
+    const size_t categoryCount = room.rules->categoryCount();
+    std::vector<std::unordered_map<std::string, int>> vetos(categoryCount);
+
+    for (auto const& [pid, voteStr] : room.playerVotes) {
+        forEachVote(voteStr, [&](size_t category, std::string_view answer) {
+            if (category < categoryCount) vetos[category][std::string(answer)]++;
+        });
+    }
+    return vetos;
+}
+
+inline const bool* knownVerdict(const Room& room, size_t category, const std::string& word) {
+    if (category >= room.knownVerdicts.size()) return nullptr;
+    auto it = room.knownVerdicts[category].find(word);
+    return it == room.knownVerdicts[category].end() ? nullptr : &it->second;
+}
+
+// Wywoluje fn(kategoria, slowo, przyjeta) dla kazdej roznej odpowiedzi, o
+// ktorej rozstrzygnelo glosowanie z kworum. Odpowiedzi z werdyktem z pamieci
+// sa pomijane, zeby pamiec nie utwierdzala sama siebie.
+template <typename Fn>
+void forEachVotedVerdict(const Room& room, Fn&& fn) {
+    const int totalPlayers = room.players.size();
+    const int voters = room.playerVotes.size();
+    if (totalPlayers < 2 || voters * 2 < totalPlayers) return;
+
+    auto vetos = countVetos(room);
+    auto cats = collectAnswers(*room.rules, room.playerAnswers);
+    for (size_t i = 0; i < cats.size(); ++i) {
+        for (const auto& word : cats[i]) {
+            if (knownVerdict(room, i, word)) continue;
+            auto veto = vetos[i].find(word);
+            int votesAgainst = veto == vetos[i].end() ? 0 : veto->second;
+            fn(i, word, isAnswerAccepted(votesAgainst, voters, totalPlayers));
+        }
+    }
+}
+
+// Zwraca punkty za runde dla kazdego gracza z room.players (w tej samej kolejnosci).
+// Kazda odpowiedz jest dzielona i haszowana raz; liczniki kategorii leza w
+// wektorze indeksowanym numerem kategorii, wiec koszt na odpowiedz nie rosnie
+// z liczba kategorii.
+inline std::vector<RoundScore> scoreRound(const Room& room) {
+    const RuleSet& rules = *room.rules;
+    const size_t categoryCount = rules.categoryCount();
+    const int totalPlayers = room.players.size();
+    const int voters = room.playerVotes.size();
+
+    std::vector<std::unordered_map<std::string, int>> vetos = countVetos(room);
+
+    // Dla kazdej zaakceptowanej odpowiedzi zapamietujemy wskaznik na jej licznik,
+    // ktory po zliczeniu wszystkich graczy mowi, czy odpowiedz jest unikalna.
+    std::vector<std::unordered_map<std::string, int>> validAnswersCounts(categoryCount);
+    std::vector<int> answerPids;
+    std::vector<std::vector<int*>> acceptedCounts;
+    answerPids.reserve(room.playerAnswers.size());
+    acceptedCounts.reserve(room.playerAnswers.size());
+
+    for (auto const& [pid, ansStr] : room.playerAnswers) {
+        auto parts = split(ansStr, ';');
+        std::vector<int*> counts;
+        counts.reserve(std::min(parts.size(), categoryCount));
+        for (size_t i = 0; i < parts.size() && i < categoryCount; ++i) {
+            std::string& word = parts[i];
+            if (word.empty()) continue;
+
+            bool accepted;
+            if (const bool* known = knownVerdict(room, i, word)) {
+                accepted = *known;
+            } else {
+                auto veto = vetos[i].find(word);
+                int votesAgainst = veto == vetos[i].end() ? 0 : veto->second;
+                accepted = isAnswerAccepted(votesAgainst, voters, totalPlayers);
+            }
+
+            if (accepted) {
+                int& count = validAnswersCounts[i][std::move(word)];
+                count++;
+                counts.push_back(&count);
+            }
+        }
+        answerPids.push_back(pid);
+        acceptedCounts.push_back(std::move(counts));
+    }
+
+    std::vector<RoundScore> scores;
+    scores.reserve(room.players.size());
+
+    for (int pid : room.players) {
+        RoundScore score;
+        auto it = std::lower_bound(answerPids.begin(), answerPids.end(), pid);
+        if (it == answerPids.end() || *it != pid) {
+            scores.push_back(score);
+            continue;
+        }
+
+        for (const int* count : acceptedCounts[it - answerPids.begin()]) {
+            score.accepted++;
+            if (*count == 1) {
+                score.points += rules.uniquePoints;
+                score.unique++;
+            } else {
+                score.points += rules.sharedPoints;
+            }
+        }
+        scores.push_back(score);
+    }
+    return scores;
+}
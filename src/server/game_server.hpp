@@ -0,0 +1,1531 @@
+#pragma once
+#include <iostream>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <map>
+#include <unordered_map>
+#include <deque>
+#include <vector>
+#include <cstring>
+#include <algorithm>
+#include <sstream>
+#include <set>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <functional>
+#include <chrono>
+#include <random>
+#include "protocol.hpp"
+#include "compression.hpp"
+#include "journal.hpp"
+#include "stats_store.hpp"
+#include "recorder.hpp"
+#include "game_logic.hpp"
+#include "spectator_fanout.hpp"
+#include "tournament.hpp"
+#include "room_timers.hpp"
+#include "idle_wheel.hpp"
+#include "session_table.hpp"
+#include "verdict_cache.hpp"
+#include "trace.hpp"
+
+#define PORT 12345
+
+// Tyle sekund po TIME_UP serwer czeka na odpowiedzi wyslane automatycznie
+// przez klientow, zanim przejdzie do weryfikacji bez brakujacych.
+constexpr int kAnswerGraceSeconds = 3;
+
+// Jeden read() czyta wprost do bufora klienta najwyzej tyle bajtow.
+constexpr size_t kReadChunk = 4096;
+
+// Bufor odbiorczy powyzej tego rozmiaru jest zmniejszany, gdy tylko
+// duza ramka zostanie przetworzona.
+constexpr size_t kReaderKeepBytes = 4 * kReadChunk;
+
+// Czasy w sekundach; 0 wylacza dany limit. loginTimeout dotyczy polaczen bez
+// LOGIN, pingAfter to bezczynnosc, po ktorej serwer wysyla PING, a po
+// idleTimeout bez zadnej ramki polaczenie jest zamykane. Pola tcp* ustawiaja
+// keepalive i TCP_USER_TIMEOUT na przyjetych gniazdach (jadro wykrywa wtedy
+// zerwane lacze nawet przy niewyslanych danych).
+struct HeartbeatConfig {
+    int loginTimeout = 30;
+    int pingAfter = 30;
+    int idleTimeout = 90;
+    int tcpKeepIdle = 60;
+    int tcpKeepInterval = 10;
+    int tcpKeepCount = 3;
+    int tcpUserTimeoutMs = 30000;
+};
+
+struct ServerConfig {
+    int port = PORT;
+    std::string journalFile;
+    std::string statsFile;
+    std::string recordFile;
+    std::string verdictCacheFile;
+    uint32_t verdictCacheSets = 4096;
+    uint32_t seed = 0;
+    bool offline = false;
+    TournamentConfig tournament;
+    HeartbeatConfig heartbeat;
+    // Tyle sekund sesja gracza, ktory stracil polaczenie, czeka na RESUME
+    // (miejsce w pokoju, punkty, odpowiedzi); 0 wylacza wznawianie.
+    int sessionGraceSeconds = 60;
+    // Plik zrzutu sladow (SIGUSR2); traceAtStart wlacza sledzenie od razu.
+    std::string traceFile = "server-trace.json";
+    bool traceAtStart = false;
+    // Komendy administracyjne ze standardowego wejscia (np. "pamiec 10").
+    bool adminConsole = false;
+};
+
+class GameServer {
+public:
+    using OutputFn = std::function<void(int fd, const std::vector<char>& frame)>;
+
+private:
+    ServerConfig config;
+    int serverPort;
+    int serverSock = -1;
+    std::vector<struct pollfd> poll_fds;
+    std::map<int, Client> clients;
+    std::map<int, Room> rooms;
+    // Nazwa -> id pokoju; nazwy sa unikalne, a sprawdzanie ich przy rozsadzaniu
+    // duzego etapu turnieju nie moze przegladac wszystkich pokoi.
+    std::unordered_map<std::string, int> roomsByName;
+    int nextRoomId = 1;
+    uint32_t seed = 0;
+    TimerQueue timers;
+    IdleWheel idleWheel;
+    SessionTable sessions;
+    int nextDetachedKey = -2;
+    uint64_t tokenState = 0;
+    std::deque<uint64_t> replayTokens;
+    std::random_device entropy;
+    std::string journalPath;
+    Journal journal;
+    StatsStore statsStore;
+    VerdictCache verdicts;
+    SessionRecorder recorder;
+    OutputFn output;
+    time_t offlineTime = 0;
+    int64_t offlineMs = 0;
+    std::string adminInput;
+    std::chrono::steady_clock::time_point startedAt = std::chrono::steady_clock::now();
+    TrafficCounters traffic;
+    std::unique_ptr<SpectatorFanout> fanout;
+    std::set<int> fanoutSockets;  // gniazda, do ktorych pisze tylko SpectatorFanout
+    Tournament tournament;
+
+    SpectatorFanout& spectatorFanout() {
+        if (!fanout) fanout = std::make_unique<SpectatorFanout>();
+        return *fanout;
+    }
+
+    static bool isSpectatorVisible(MsgType type) {
+        switch (type) {
+            case MsgType::GAME_STARTED:
+            case MsgType::TIME_LEFT:
+            case MsgType::VERIFICATION_START:
+            case MsgType::ROUND_END:
+            case MsgType::GAME_END:
+            case MsgType::HOST_LEFT:
+            case MsgType::HOST_CHANGED:
+                return true;
+            default:
+                return false;
+        }
+    }
+
+    // W trybie offline limity wiadomosci tez ida wedlug zegara wirtualnego.
+    uint32_t monotonicMs() const {
+        if (config.offline) return static_cast<uint32_t>(offlineMs);
+        return std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - startedAt).count();
+    }
+
+    time_t now() const {
+        return config.offline ? offlineTime : time(NULL);
+    }
+
+    void setNonBlocking(int sock) {
+        int flags = fcntl(sock, F_GETFL, 0);
+        fcntl(sock, F_SETFL, flags | O_NONBLOCK);
+    }
+
+    void applyKeepAlive(int sock) {
+        const auto& hb = config.heartbeat;
+        if (hb.tcpKeepIdle > 0) {
+            int on = 1;
+            setsockopt(sock, SOL_SOCKET, SO_KEEPALIVE, &on, sizeof(on));
+            setsockopt(sock, IPPROTO_TCP, TCP_KEEPIDLE, &hb.tcpKeepIdle, sizeof(hb.tcpKeepIdle));
+            if (hb.tcpKeepInterval > 0) setsockopt(sock, IPPROTO_TCP, TCP_KEEPINTVL, &hb.tcpKeepInterval, sizeof(hb.tcpKeepInterval));
+            if (hb.tcpKeepCount > 0) setsockopt(sock, IPPROTO_TCP, TCP_KEEPCNT, &hb.tcpKeepCount, sizeof(hb.tcpKeepCount));
+        }
+#ifdef TCP_USER_TIMEOUT
+        if (hb.tcpUserTimeoutMs > 0) {
+            unsigned int timeoutMs = hb.tcpUserTimeoutMs;
+            setsockopt(sock, IPPROTO_TCP, TCP_USER_TIMEOUT, &timeoutMs, sizeof(timeoutMs));
+        }
+#endif
+    }
+
+    static bool isDetachedKey(int key) {
+        return key < -1;
+    }
+
+    void sendFrame(int fd, const std::vector<char>& frame) {
+        if (isDetachedKey(fd)) return;
+        if (output) {
+            output(fd, frame);
+            return;
+        }
+        if (!fanoutSockets.empty() && fanoutSockets.count(fd)) {
+            spectatorFanout().send(fd, std::make_shared<const std::vector<char>>(frame));
+            return;
+        }
+        send(fd, frame.data(), frame.size(), 0);
+    }
+
+    void sendToClient(int fd, MsgType type, const std::string& data) {
+        auto it = clients.find(fd);
+        std::vector<char> compressed;
+        if (it != clients.end() && it->second.acceptsCompressed && compressFrame(type, data, compressed)) {
+            sendFrame(fd, compressed);
+            return;
+        }
+        sendFrame(fd, createMessage(type, data));
+    }
+
+    bool anyAcceptsCompressed(const std::vector<int>& fds) {
+        for (int fd : fds) {
+            if (clients[fd].acceptsCompressed) return true;
+        }
+        return false;
+    }
+
+    // Ramka jest kodowana (i ewentualnie kompresowana) raz dla calego pokoju.
+    void broadcastToRoom(int roomId, MsgType type, const std::string& data) {
+        TraceSpan span("broadcastToRoom", roomId);
+        tournament.activeRooms.erase(roomId);
+        auto it = rooms.find(roomId);
+        if (it == rooms.end()) return;
+        const auto& room = it->second;
+        bool toSpectators = !room.spectators.empty() && isSpectatorVisible(type);
+
+        SharedFrame frame = std::make_shared<const std::vector<char>>(createMessage(type, data));
+        SharedFrame compressed;
+        if (data.size() >= kCompressionThreshold
+            && (anyAcceptsCompressed(room.players) || (toSpectators && anyAcceptsCompressed(room.spectators)))) {
+            std::vector<char> packed;
+            if (compressFrame(type, data, packed)) compressed = std::make_shared<const std::vector<char>>(std::move(packed));
+        }
+
+        for (int playerFd : room.players) {
+            sendFrame(playerFd, compressed && clients[playerFd].acceptsCompressed ? *compressed : *frame);
+        }
+        if (toSpectators) publishToSpectators(room, type, frame, compressed);
+    }
+
+    // Offline nie ma gniazd do przekazania watkom, ramki ida wprost do output.
+    void publishToSpectators(const Room& room, MsgType type, const SharedFrame& frame, const SharedFrame& compressed = nullptr) {
+        if (output) {
+            for (int fd : room.spectators) {
+                sendFrame(fd, compressed && clients[fd].acceptsCompressed ? *compressed : *frame);
+            }
+            return;
+        }
+        spectatorFanout().publish(room.id, type, frame, compressed);
+    }
+
+    void notifySpectators(int roomId, MsgType type, const std::string& data) {
+        auto it = rooms.find(roomId);
+        if (it != rooms.end() && !it->second.spectators.empty()) {
+            publishToSpectators(it->second, type, std::make_shared<const std::vector<char>>(createMessage(type, data)));
+        }
+    }
+
+    void stopSpectating(Client& client) {
+        int roomId = client.spectatingRoomId;
+        client.spectatingRoomId = -1;
+        tournament.activeRooms.erase(roomId);
+        auto it = rooms.find(roomId);
+        if (it == rooms.end()) return;
+        auto& spectators = it->second.spectators;
+        spectators.erase(std::remove(spectators.begin(), spectators.end(), client.fd), spectators.end());
+        if (fanoutSockets.count(client.fd)) spectatorFanout().leaveRoom(roomId, client.fd);
+    }
+
+    void eraseRoom(int roomId) {
+        journal.append(JournalEvent::ROOM_CLOSE, roomId, "");
+        tournament.activeRooms.erase(roomId);
+        auto it = rooms.find(roomId);
+        if (it == rooms.end()) return;
+        if (!it->second.spectators.empty()) {
+            for (int fd : it->second.spectators) {
+                clients[fd].spectatingRoomId = -1;
+            }
+            if (fanout) fanout->closeRoom(roomId);
+        }
+        roomsByName.erase(it->second.name);
+        rooms.erase(it);
+    }
+
+    struct RecoveredRoom {
+        std::string name;
+        std::set<std::string> players;
+        int round = 0;
+        std::string scores;
+    };
+
+    void recoverFromJournal() {
+        std::map<int, RecoveredRoom> open;
+        int maxRoomId = 0;
+
+        size_t count = Journal::replay(journalPath, [&](const JournalRecordHeader& h, const char* data) {
+            int roomId = h.roomId;
+            std::string text(data, h.len);
+            maxRoomId = std::max(maxRoomId, roomId);
+            switch (h.event) {
+                case JournalEvent::ROOM_CREATE:
+                    open[roomId].name = text;
+                    break;
+                case JournalEvent::ROOM_JOIN:
+                    open[roomId].players.insert(text);
+                    break;
+                case JournalEvent::ROOM_LEAVE:
+                    open[roomId].players.erase(text);
+                    break;
+                case JournalEvent::ROUND_START:
+                    open[roomId].round++;
+                    break;
+                case JournalEvent::SCORES:
+                    open[roomId].scores = text;
+                    break;
+                case JournalEvent::ROOM_CLOSE:
+                case JournalEvent::GAME_END:
+                    open.erase(roomId);
+                    break;
+                default:
+                    break;
+            }
+        });
+
+        if (count == 0) return;
+        nextRoomId = maxRoomId + 1;
+        std::cout << "Odtworzono " << count << " zdarzen z dziennika" << std::endl;
+
+        for (const auto& [roomId, room] : open) {
+            std::cout << "Przerwana gra w pokoju " << room.name << " (runda " << room.round
+                      << ", gracze: " << room.players.size() << ") wyniki: " << room.scores << std::endl;
+            journal.append(JournalEvent::ROOM_CLOSE, roomId, "");
+        }
+    }
+
+    void calculateScores(int roomId) {
+        TraceSpan span("calculateScores", roomId);
+        Room& room = rooms[roomId];
+
+        std::vector<RoundScore> scores = scoreRound(room);
+        forEachVotedVerdict(room, [&](size_t category, const std::string& word, bool accepted) {
+            verdicts.record(room.rules->categories[category], room.letter, word, accepted, room.id);
+        });
+
+        std::string roundSummary = "";
+        std::string totalSummary = "";
+
+        for (size_t idx = 0; idx < room.players.size(); ++idx) {
+            Client& c = clients[room.players[idx]];
+            const RoundScore& rs = scores[idx];
+
+            roundSummary += c.nick + ":" + std::to_string(rs.points) + ";";
+
+            c.score += rs.points;
+            c.answersGiven += rs.accepted;
+            c.uniqueAnswers += rs.unique;
+            totalSummary += c.nick + ":" + std::to_string(c.score) + ";";
+        }
+
+        broadcastToRoom(roomId, MsgType::ROUND_END, roundSummary);
+        journal.append(JournalEvent::SCORES, roomId, totalSummary);
+
+        room.playerAnswers.clear();
+        room.playerVotes.clear();
+        room.knownVerdicts.clear();
+        room.verificationInfo.clear();
+
+        if (room.currentRound < room.rules->maxRounds) {
+            enterPhase(room, RoomPhase::INTERMISSION, now());
+        } else {
+            broadcastToRoom(roomId, MsgType::GAME_END, totalSummary);
+            if (room.tournament) recordTournamentGame(room);
+            std::vector<GameResult> results;
+            for (int pid : room.players) {
+                const Client& c = clients[pid];
+                results.push_back({c.nick, c.score, c.answersGiven, c.uniqueAnswers});
+                clients[pid].currentRoomId = -1;
+            }
+            statsStore.applyGame(results);
+            journal.append(JournalEvent::GAME_END, roomId, "");
+            eraseRoom(roomId);
+        }
+    }
+
+    using MessageHandler = void (GameServer::*)(Client&, std::string_view);
+
+    void handleLogin(Client& client, std::string_view data) {
+        // Drugi LOGIN wydalby nowy token, a stary dalej wskazywalby te sesje.
+        if (!client.nick.empty()) {
+            sendToClient(client.fd, MsgType::LOGIN_FAIL, "Jestes juz zalogowany");
+            return;
+        }
+
+        bool nickTaken = false;
+        for (const auto& pair : clients) {
+            if (pair.second.nick == data) {
+                nickTaken = true;
+                break;
+            }
+        }
+
+        if (nickTaken) {
+            sendToClient(client.fd, MsgType::LOGIN_FAIL, "Nick jest zajety!");
+        } else {
+            client.nick = std::string(data);
+            client.resumeToken = newResumeToken();
+            sessions.set(client.resumeToken, client.fd);
+            recorder.record(RecordKind::TOKEN, client.fd, MsgType::LOGIN_OK,
+                            reinterpret_cast<const char*>(&client.resumeToken), sizeof(client.resumeToken));
+            sendToClient(client.fd, MsgType::LOGIN_OK, formatResumeToken(client.resumeToken));
+        }
+    }
+
+    // Na zywo token pochodzi z random_device, zeby nie dalo sie go
+    // przewidziec z wlasnego; w trybie offline z ziarna, dla powtarzalnosci.
+    // Nagranie zapisuje wydane tokeny (RecordKind::TOKEN), a odtwarzanie
+    // podaje je z powrotem przez replayResumeTokens, zeby RESUME z nagrania
+    // trafial w te same sesje.
+    uint64_t newResumeToken() {
+        if (!replayTokens.empty()) {
+            uint64_t token = replayTokens.front();
+            replayTokens.pop_front();
+            return token;
+        }
+        uint64_t token = 0;
+        while (token == 0 || sessions.find(token) != SessionTable::kNotFound) {
+            if (config.offline) token = splitMix64(tokenState);
+            else token = (static_cast<uint64_t>(entropy()) << 32) | entropy();
+        }
+        return token;
+    }
+
+    static std::string formatResumeToken(uint64_t token) {
+        char text[kResumeTokenLen + 1];
+        std::snprintf(text, sizeof(text), "%016llx", static_cast<unsigned long long>(token));
+        return text;
+    }
+
+    // "RESUME token" na nowym polaczeniu przejmuje sesje odlaczona (albo
+    // jeszcze nieuznana za zerwana) razem z miejscem w pokoju i punktami.
+    void handleResume(Client& client, std::string_view data) {
+        if (!client.nick.empty()) return;
+        uint64_t token = decodeResumeToken(data);
+        int key = sessions.find(token);
+        if (key >= 0 && key != client.fd) {
+            // Stare polaczenie wciaz wisi (np. zmiana sieci w telefonie).
+            handleDisconnect(key, true);
+            key = sessions.find(token);
+        }
+        if (!isDetachedKey(key)) {
+            sendToClient(client.fd, MsgType::RESUME_FAIL, "Sesja wygasla");
+            return;
+        }
+
+        Client& session = clients[key];
+        client.nick = std::move(session.nick);
+        client.currentRoomId = session.currentRoomId;
+        client.score = session.score;
+        client.answersGiven = session.answersGiven;
+        client.uniqueAnswers = session.uniqueAnswers;
+        client.resumeToken = session.resumeToken;
+        rekeyReferences(client, key, client.fd);
+        clients.erase(key);
+        // Odlaczony gospodarz zostaje tylko wtedy, gdy nikt z pokoju nie jest
+        // polaczony, wiec pierwszy wracajacy przejmuje pokoj.
+        auto room = rooms.find(client.currentRoomId);
+        if (room != rooms.end() && isDetachedKey(room->second.hostFd)) room->second.hostFd = client.fd;
+        if (!config.offline) std::cout << "Klient " << client.fd << " wznowil sesje " << client.nick << std::endl;
+        sendRoomState(client);
+    }
+
+    // RESUME_OK: "nick;pokoj;gracz,gracz,..." (pokoj pusty, gdy gracz jest
+    // w lobby), a w trakcie rundy takze biezacy etap gry.
+    void sendRoomState(Client& client) {
+        auto it = rooms.find(client.currentRoomId);
+        if (it == rooms.end()) {
+            sendToClient(client.fd, MsgType::RESUME_OK, client.nick + ";;");
+            return;
+        }
+        const Room& room = it->second;
+        std::string playerListStr = "";
+        for (int pid : room.players) {
+            if (!playerListStr.empty()) playerListStr += ",";
+            playerListStr += clients[pid].nick;
+        }
+        sendToClient(client.fd, MsgType::RESUME_OK, client.nick + ";" + room.name + ";" + playerListStr);
+        // Gospodarz mogl sie zmienic pod nieobecnosc gracza. Pokoje turniejowe
+        // nie maja gospodarza (hostFd == -1).
+        auto host = room.hostFd < 0 ? clients.end() : clients.find(room.hostFd);
+        if (host != clients.end()) sendToClient(client.fd, MsgType::HOST_CHANGED, host->second.nick);
+
+        if (room.phase == RoomPhase::ANSWERING) {
+            sendToClient(client.fd, MsgType::GAME_STARTED, room.roundInfo);
+            sendToClient(client.fd, MsgType::TIME_LEFT, std::to_string(std::max<time_t>(0, room.phaseDeadline - now())));
+        } else if (room.phase == RoomPhase::VERIFYING) {
+            sendToClient(client.fd, MsgType::VERIFICATION_START, room.verificationInfo);
+        }
+    }
+
+    // Przenosi odwolania do gracza (pokoj, odpowiedzi, glosy, turniej,
+    // token) z klucza `from` na `to`.
+    void rekeyReferences(Client& client, int from, int to) {
+        if (client.resumeToken) sessions.set(client.resumeToken, to);
+        tournament.rekey(from, to);
+        auto it = rooms.find(client.currentRoomId);
+        if (it == rooms.end()) return;
+        Room& room = it->second;
+        std::replace(room.players.begin(), room.players.end(), from, to);
+        if (room.hostFd == from) room.hostFd = to;
+        for (auto* entries : {&room.playerAnswers, &room.playerVotes}) {
+            auto node = entries->extract(from);
+            if (node) {
+                node.key() = to;
+                entries->insert(std::move(node));
+            }
+        }
+    }
+
+    // Gracz zostaje w pokoju pod ujemnym kluczem; ramki do niego sa pomijane
+    // w sendFrame, a termin wygasniecia pilnuje kolo bezczynnosci.
+    void detachSession(int fd) {
+        int key = nextDetachedKey--;
+        auto node = clients.extract(fd);
+        node.key() = key;
+        Client& client = clients.insert(std::move(node)).position->second;
+        client.fd = key;
+        client.detachedAt = now();
+        client.pingSent = false;
+        client.reader.release();
+        client.rate = ClientRateState();
+        rekeyReferences(client, fd, key);
+        auto room = rooms.find(client.currentRoomId);
+        if (room != rooms.end() && room->second.hostFd == key) migrateHost(room->second);
+        scheduleIdleCheck(client, now());
+    }
+
+    void dropSession(Client& client) {
+        int key = client.fd;
+        sessions.erase(client.resumeToken);
+        tournament.remove(key);
+        leaveRoom(client);
+        clients.erase(key);
+    }
+
+    void handleCreateRoom(Client& client, std::string_view data) {
+        if (client.nick.empty()) return; 
+
+        CreateRoomView request = decodeCreateRoom(data);
+        const RuleSet* rules = request.hasRules ? findRules(request.rulesId) : &defaultRules();
+        if (!rules) {
+            sendToClient(client.fd, MsgType::CREATE_ROOM_FAIL, "Nieznany zestaw zasad!");
+            return;
+        }
+        if (request.name.empty() || request.name.size() > kMaxNameLen) {
+            sendToClient(client.fd, MsgType::CREATE_ROOM_FAIL, "Niepoprawna nazwa pokoju!");
+            return;
+        }
+        std::string roomName(request.name);
+        
+        if (roomNameTaken(roomName)) {
+            sendToClient(client.fd, MsgType::CREATE_ROOM_FAIL, "Nazwa pokoju jest zajeta!");
+            return;
+        }
+        int newId = createRoom(roomName, client.fd);
+        rooms[newId].rules = rules;
+        seatInRoom(newId, client);
+        
+        sendToClient(client.fd, MsgType::CREATE_ROOM_OK, roomName);
+    }
+
+    bool roomNameTaken(const std::string& name) const {
+        return roomsByName.count(name) != 0;
+    }
+
+    Room* findRoomByName(std::string_view name) {
+        auto it = roomsByName.find(std::string(name));
+        return it == roomsByName.end() ? nullptr : &rooms[it->second];
+    }
+
+    int createRoom(const std::string& name, int hostFd) {
+        int newId = nextRoomId++;
+        Room& room = rooms[newId];
+        room.id = newId;
+        room.name = name;
+        room.hostFd = hostFd;
+        roomsByName[name] = newId;
+        room.letters.seed(roomLetterSeed(seed, newId));
+        journal.append(JournalEvent::ROOM_CREATE, newId, name);
+        return newId;
+    }
+
+    void seatInRoom(int roomId, Client& client) {
+        rooms[roomId].players.push_back(client.fd);
+        client.currentRoomId = roomId;
+        journal.append(JournalEvent::ROOM_JOIN, roomId, client.nick);
+    }
+
+    void handleGetRoomList(Client& client, std::string_view) {
+        sendToClient(client.fd, MsgType::ROOM_LIST, buildRoomList(rooms));
+    }
+
+    void handleGetLeaderboard(Client& client, std::string_view data) {
+        sendToClient(client.fd, MsgType::LEADERBOARD, statsStore.top(decodeLeaderboardRequest(data)));
+    }
+
+    void handleJoinRoom(Client& client, std::string_view data) {
+        if (client.nick.empty()) return;
+        if (client.currentRoomId != -1 || client.spectatingRoomId != -1) {
+            sendToClient(client.fd, MsgType::JOIN_ROOM_FAIL, "Jestes juz w pokoju");
+            return;
+        }
+
+        Room* target = findRoomByName(data);
+        bool found = target && !target->gameStarted() && !target->tournament;
+        int roomId = found ? target->id : -1;
+        
+        if (found) {
+            seatInRoom(roomId, client);
+            
+            std::string playerListStr = "";
+            for (int pid : rooms[roomId].players) {
+                if (!playerListStr.empty()) playerListStr += ",";
+                playerListStr += clients[pid].nick;
+            }
+
+            sendToClient(client.fd, MsgType::JOIN_ROOM_OK, rooms[roomId].name + ";" + playerListStr);
+            
+            for (int pid : rooms[roomId].players) {
+                if (pid != client.fd) {
+                    sendToClient(pid, MsgType::NEW_PLAYER_JOINED, client.nick);
+                }
+            }
+        } else {
+            sendToClient(client.fd, MsgType::JOIN_ROOM_FAIL, "Brak pokoju o takiej nazwie");
+        }
+    }
+
+    void handleSpectateRoom(Client& client, std::string_view data) {
+        if (client.nick.empty()) return;
+        if (client.currentRoomId != -1 || client.spectatingRoomId != -1) {
+            sendToClient(client.fd, MsgType::SPECTATE_FAIL, "Jestes juz w pokoju");
+            return;
+        }
+
+        Room* target = findRoomByName(data);
+        if (!target) {
+            sendToClient(client.fd, MsgType::SPECTATE_FAIL, "Brak pokoju o takiej nazwie");
+            return;
+        }
+
+        Room& room = *target;
+        room.spectators.push_back(client.fd);
+        client.spectatingRoomId = room.id;
+
+        // Od teraz do rozlaczenia do gniazda pisze tylko watek rozsylajacy,
+        // takze gdy klient przestanie obserwowac i dolaczy do gry.
+        if (!output && !fanoutSockets.count(client.fd) && spectatorFanout().adopt(client.fd, client.acceptsCompressed)) {
+            fanoutSockets.insert(client.fd);
+        }
+
+        std::string playerListStr = "";
+        for (int pid : room.players) {
+            if (!playerListStr.empty()) playerListStr += ",";
+            playerListStr += clients[pid].nick;
+        }
+        sendToClient(client.fd, MsgType::SPECTATE_OK, room.name + ";" + playerListStr);
+        if (room.gameStarted() && !room.roundInfo.empty()) {
+            sendToClient(client.fd, MsgType::GAME_STARTED, room.roundInfo);
+        }
+        if (fanoutSockets.count(client.fd)) spectatorFanout().joinRoom(room.id, client.fd);
+    }
+
+    void handleStartGame(Client& client, std::string_view) {
+        int roomId = client.currentRoomId;
+        if (roomId == -1 || rooms.find(roomId) == rooms.end()) return;
+
+        Room& room = rooms[roomId];
+
+        if (room.hostFd != client.fd) {
+            sendToClient(client.fd, MsgType::GAME_START_FAIL, "Nie jestes hostem!");
+            return;
+        }
+
+        if (room.players.size() < 2) { 
+            sendToClient(client.fd, MsgType::GAME_START_FAIL, "Za malo graczy!");
+            return;
+        }
+
+        startGame(roomId);
+    }
+
+    void startGame(int roomId) {
+        Room& room = rooms[roomId];
+        room.currentRound = 1;
+        room.letters.reset();
+        for (int pid : room.players) {
+            clients[pid].score = 0;
+            clients[pid].answersGiven = 0;
+            clients[pid].uniqueAnswers = 0;
+        }
+        room.playerAnswers.clear();
+        room.playerVotes.clear();
+        beginRound(room, now());
+    }
+
+    // GAME_STARTED: "litera;runda;liczba_rund;sekundy;kategoria,kategoria,..."
+    void beginRound(Room& room, time_t now) {
+        const RuleSet& rules = *room.rules;
+        char letter = room.letters.next();
+        std::string gameData = std::string(1, letter) + ";" + std::to_string(room.currentRound) + ";" + std::to_string(rules.maxRounds)
+                             + ";" + std::to_string(rules.answerSeconds) + ";" + rules.categoryList;
+        room.roundInfo = gameData;
+        room.letter = letter;
+        broadcastToRoom(room.id, MsgType::GAME_STARTED, gameData);
+        journal.append(JournalEvent::ROUND_START, room.id, gameData);
+        enterPhase(room, RoomPhase::ANSWERING, now);
+    }
+
+    // Zmiana fazy uniewaznia terminy poprzedniej (nowa generacja) i planuje
+    // terminy nowej.
+    void enterPhase(Room& room, RoomPhase phase, time_t now) {
+        room.phase = phase;
+        room.timerGeneration++;
+        room.phaseDeadline = 0;
+        switch (phase) {
+            case RoomPhase::ANSWERING:
+                room.phaseDeadline = now + room.rules->answerSeconds;
+                timers.push(now + 1, room.id, room.timerGeneration, RoomTimer::TICK);
+                break;
+            case RoomPhase::VERIFYING:
+                room.phaseDeadline = now + room.rules->voteSeconds;
+                break;
+            case RoomPhase::INTERMISSION:
+                room.phaseDeadline = now + room.rules->intermissionSeconds;
+                break;
+            case RoomPhase::LOBBY:
+                break;
+        }
+        if (room.phaseDeadline != 0) {
+            timers.push(room.phaseDeadline, room.id, room.timerGeneration, RoomTimer::DEADLINE);
+        }
+    }
+
+    void onRoomTimer(Room& room, RoomTimer kind, time_t now) {
+        if (kind == RoomTimer::TICK) {
+            time_t remaining = room.phaseDeadline - now;
+            if (room.phase == RoomPhase::ANSWERING && remaining > 0) {
+                broadcastToRoom(room.id, MsgType::TIME_LEFT, std::to_string(remaining));
+                timers.push(now + 1, room.id, room.timerGeneration, RoomTimer::TICK);
+            }
+            return;
+        }
+        if (kind == RoomTimer::GRACE) {
+            if (room.phase == RoomPhase::ANSWERING) startVerification(room, now);
+            return;
+        }
+
+        switch (room.phase) {
+            case RoomPhase::ANSWERING:
+                // Klienci po TIME_UP sami wysylaja to, co zdazyli wpisac.
+                broadcastToRoom(room.id, MsgType::TIME_UP, "");
+                timers.push(now + kAnswerGraceSeconds, room.id, room.timerGeneration, RoomTimer::GRACE);
+                break;
+            case RoomPhase::VERIFYING:
+                // Liczymy na glosach, ktore przyszly; kworum rozstrzyga isAnswerAccepted.
+                calculateScores(room.id);
+                break;
+            case RoomPhase::INTERMISSION:
+                room.currentRound++;
+                beginRound(room, now);
+                break;
+            case RoomPhase::LOBBY:
+                break;
+        }
+    }
+
+    void startVerification(Room& room, time_t now) {
+        enterPhase(room, RoomPhase::VERIFYING, now);
+
+        const RuleSet& rules = *room.rules;
+        auto cats = collectAnswers(rules, room.playerAnswers);
+        room.knownVerdicts.assign(cats.size(), {});
+        size_t undecided = 0;
+        for (size_t i = 0; i < cats.size(); ++i) {
+            for (const auto& word : cats[i]) {
+                Verdict verdict = verdicts.lookup(rules.categories[i], room.letter, word);
+                if (verdict == Verdict::UNKNOWN) undecided++;
+                else room.knownVerdicts[i][word] = verdict == Verdict::ACCEPTED;
+            }
+        }
+        room.verificationInfo = buildVerificationPayload(rules, cats, room.knownVerdicts);
+        broadcastToRoom(room.id, MsgType::VERIFICATION_START, room.verificationInfo);
+
+        // Wszystko rozstrzygnela pamiec werdyktow: nie ma na co czekac.
+        if (undecided == 0) calculateScores(room.id);
+    }
+
+    // Sprawdza, czy biezaca faza moze sie zakonczyc (po odpowiedzi, glosie
+    // albo odejsciu gracza).
+    void advanceRoom(int roomId) {
+        auto it = rooms.find(roomId);
+        if (it == rooms.end() || it->second.players.empty()) return;
+        Room& room = it->second;
+
+        if (room.phase == RoomPhase::ANSWERING && room.playerAnswers.size() >= room.players.size()) {
+            startVerification(room, now());
+        } else if (room.phase == RoomPhase::VERIFYING && room.playerVotes.size() >= room.players.size()) {
+            calculateScores(roomId);
+        }
+    }
+
+    void handleSubmitAnswers(Client& client, std::string_view data) {
+        int roomId = client.currentRoomId;
+        auto it = rooms.find(roomId);
+        if (it == rooms.end() || it->second.phase != RoomPhase::ANSWERING) return;
+        
+        Room& room = it->second;
+        std::string& answers = room.playerAnswers[client.fd];
+        answers = sanitizeAnswers(data);
+        journal.append(JournalEvent::ANSWERS, roomId, client.nick + '\0' + answers);
+        advanceRoom(roomId);
+    }
+
+    void handleSendVote(Client& client, std::string_view data) {
+        int roomId = client.currentRoomId;
+        auto it = rooms.find(roomId);
+        if (it == rooms.end() || it->second.phase != RoomPhase::VERIFYING) return;
+        
+        Room& room = it->second;
+        std::string& votes = room.playerVotes[client.fd];
+        votes.assign(data);
+        journal.append(JournalEvent::VOTE, roomId, client.nick + '\0' + votes);
+        advanceRoom(roomId);
+    }
+
+    void leaveRoom(Client& client) {
+        int roomId = client.currentRoomId;
+        client.currentRoomId = -1;
+        tournament.activeRooms.erase(roomId);
+        auto it = rooms.find(roomId);
+        if (it == rooms.end()) return;
+
+        Room& room = it->second;
+        bool wasHost = (client.fd == room.hostFd);
+        room.players.erase(std::remove(room.players.begin(), room.players.end(), client.fd), room.players.end());
+        room.playerAnswers.erase(client.fd);
+        room.playerVotes.erase(client.fd);
+        journal.append(JournalEvent::ROOM_LEAVE, roomId, client.nick);
+        if (room.players.empty()) {
+            eraseRoom(roomId);
+            return;
+        }
+        for (int pid : room.players) {
+            sendToClient(pid, MsgType::PLAYER_LEFT, client.nick);
+        }
+        if (wasHost) migrateHost(room);
+        advanceRoom(roomId);
+    }
+
+    // Pokoj po odejsciu gospodarza nie jest zamykany: gospodarzem zostaje
+    // najdluzej obecny gracz z aktywnym polaczeniem (odlaczeni nie moga
+    // wystartowac gry), a trwajaca gra toczy sie dalej. Gdy polaczonych
+    // brak, gospodarzem zostaje pierwszy z odlaczonych.
+    void migrateHost(Room& room) {
+        if (room.players.empty()) return;
+        auto it = std::find_if(room.players.begin(), room.players.end(), [&](int pid) { return !isDetachedKey(pid); });
+        room.hostFd = it != room.players.end() ? *it : room.players.front();
+        auto host = clients.find(room.hostFd);
+        if (host == clients.end()) return;
+        const std::string nick = host->second.nick;
+        for (int pid : room.players) {
+            sendToClient(pid, MsgType::HOST_CHANGED, nick);
+        }
+        notifySpectators(room.id, MsgType::HOST_CHANGED, nick);
+    }
+
+    void handleLeaveRoom(Client& client, std::string_view) {
+        if (client.spectatingRoomId != -1) {
+            stopSpectating(client);
+            return;
+        }
+        leaveRoom(client);
+    }
+
+    void handleTournamentJoin(Client& client, std::string_view) {
+        if (client.nick.empty()) return;
+        if (client.currentRoomId != -1 || client.spectatingRoomId != -1) return;
+        if (tournament.participants.count(client.fd)) return;
+
+        tournament.enqueue(client.fd);
+        sendToClient(client.fd, MsgType::TOURNAMENT_QUEUED, std::to_string(tournament.waiting()));
+        if (!tournament.running() && tournament.seatAt == 0 && tournament.waiting() >= config.tournament.minPlayers) {
+            tournament.seatAt = now() + config.tournament.registrationSeconds;
+        }
+    }
+
+    // Zwyciezca pokoju przechodzi dalej; punkty wszystkich trafiaja do klasyfikacji turnieju.
+    void recordTournamentGame(const Room& room) {
+        int winner = -1;
+        for (int pid : room.players) {
+            const Client& c = clients[pid];
+            tournament.totals[c.nick] += c.score;
+            if (winner == -1 || c.score > clients[winner].score) winner = pid;
+        }
+        if (winner != -1) tournament.winners.push_back(winner);
+    }
+
+    void seatTournamentStage(time_t now) {
+        auto seatStart = std::chrono::steady_clock::now();
+
+        std::vector<int> players;
+        if (tournament.running()) {
+            players.swap(tournament.winners);
+        } else {
+            players = tournament.take(tournament.waiting());
+        }
+        players.erase(std::remove_if(players.begin(), players.end(), [&](int fd) {
+            auto it = clients.find(fd);
+            return it == clients.end() || it->second.currentRoomId != -1 || it->second.spectatingRoomId != -1;
+        }), players.end());
+
+        if (players.size() < 2) {
+            if (tournament.running()) {
+                finishTournament(players.empty() ? -1 : players.front(), now);
+            } else {
+                for (int fd : players) tournament.enqueue(fd);
+            }
+            return;
+        }
+
+        tournament.stage++;
+        auto tables = seatPlayers(players, config.tournament.roomSize);
+        for (size_t k = 0; k < tables.size(); ++k) {
+            // Gracz mogl wczesniej sam zalozyc pokoj o takiej nazwie.
+            std::string base = "Turniej " + std::to_string(tournament.stage) + "-" + std::to_string(k + 1);
+            std::string name = base;
+            for (int n = 2; roomNameTaken(name); ++n) name = base + " (" + std::to_string(n) + ")";
+            int roomId = createRoom(name, -1);
+            Room& room = rooms[roomId];
+            room.tournament = true;
+
+            std::string playerListStr = "";
+            for (int fd : tables[k]) {
+                Client& c = clients[fd];
+                seatInRoom(roomId, c);
+                tournament.participants.insert(fd);
+                if (!playerListStr.empty()) playerListStr += ",";
+                playerListStr += c.nick;
+            }
+            for (int fd : room.players) {
+                sendToClient(fd, MsgType::JOIN_ROOM_OK, name + ";" + playerListStr);
+            }
+            tournament.activeRooms.insert(roomId);
+            tournament.pendingStart.push_back(roomId);
+        }
+        tournament.startAt = now + config.tournament.startDelaySeconds;
+
+        auto seatUs = std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - seatStart).count();
+        std::cout << "Turniej: etap " << tournament.stage << ", graczy: " << players.size()
+                  << ", pokoi: " << tables.size() << ", rozsadzanie: " << seatUs << " us" << std::endl;
+    }
+
+    void startTournamentStage() {
+        for (int roomId : tournament.pendingStart) {
+            if (rooms.count(roomId)) startGame(roomId);
+        }
+        tournament.pendingStart.clear();
+        tournament.stageClock = std::chrono::steady_clock::now();
+    }
+
+    void finishTournamentStage(time_t now) {
+        auto stageMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - tournament.stageClock).count();
+        std::cout << "Turniej: koniec etapu " << tournament.stage << " po " << stageMs
+                  << " ms, awansuje: " << tournament.winners.size() << std::endl;
+
+        if (tournament.winners.size() <= 1) {
+            finishTournament(tournament.winners.empty() ? -1 : tournament.winners.front(), now);
+            return;
+        }
+        for (int fd : tournament.winners) {
+            sendToClient(fd, MsgType::TOURNAMENT_QUEUED, "0");
+        }
+        tournament.seatAt = now + config.tournament.stageBreakSeconds;
+    }
+
+    void finishTournament(int championFd, time_t now) {
+        std::vector<std::pair<int, std::string>> standings;
+        for (const auto& [nick, points] : tournament.totals) standings.push_back({points, nick});
+        std::sort(standings.begin(), standings.end(), [](const auto& a, const auto& b) { return a.first > b.first; });
+
+        std::string payload = (championFd != -1 ? clients[championFd].nick : "") + ";" + std::to_string(tournament.stage) + ";";
+        for (const auto& [points, nick] : standings) {
+            payload += nick + ":" + std::to_string(points) + ";";
+        }
+        for (int fd : tournament.participants) {
+            sendToClient(fd, MsgType::TOURNAMENT_END, payload);
+        }
+        std::cout << "Turniej zakonczony po " << tournament.stage << " etapach" << std::endl;
+
+        tournament.reset();
+        if (tournament.waiting() >= config.tournament.minPlayers) {
+            tournament.seatAt = now + config.tournament.registrationSeconds;
+        }
+    }
+
+    void processTournament(time_t now) {
+        if (tournament.seatAt != 0 && now >= tournament.seatAt) {
+            tournament.seatAt = 0;
+            seatTournamentStage(now);
+        }
+        if (!tournament.pendingStart.empty() && now >= tournament.startAt) {
+            startTournamentStage();
+        }
+        if (tournament.running() && tournament.seatAt == 0 && !tournament.stageRunning()) {
+            finishTournamentStage(now);
+        }
+    }
+
+    void handlePing(Client& client, std::string_view) {
+        sendToClient(client.fd, MsgType::PONG, "");
+    }
+
+    // Sama ramka odswieza lastActivity w handleFrame, wiec PONG nie ma nic do zrobienia.
+    void handlePong(Client&, std::string_view) {}
+
+    void addClient(int fd) {
+        Client newClient;
+        newClient.fd = fd;
+        newClient.connectedAt = newClient.lastActivity = now();
+        Client& client = clients[fd] = std::move(newClient);
+        scheduleIdleCheck(client, now());
+    }
+
+    // Najblizszy moment, w ktorym stan klienta moze sie zmienic: koniec czasu
+    // na LOGIN, wyslanie PING albo zamkniecie. Wczesniejsza aktywnosc tylko
+    // przesuwa lastActivity, a sprawdzenie po prostu wyliczy termin od nowa.
+    void scheduleIdleCheck(Client& client, time_t now) {
+        const auto& hb = config.heartbeat;
+        time_t next = 0;
+        auto consider = [&](int seconds, time_t from) {
+            if (seconds <= 0) return;
+            time_t at = std::max(from + seconds, now + 1);
+            if (next == 0 || at < next) next = at;
+        };
+        if (isDetachedKey(client.fd)) {
+            consider(config.sessionGraceSeconds, client.detachedAt);
+        } else {
+            if (client.nick.empty()) consider(hb.loginTimeout, client.connectedAt);
+            if (!client.pingSent) consider(hb.pingAfter, client.lastActivity);
+            consider(hb.idleTimeout, client.lastActivity);
+        }
+        if (next == 0) return;
+        client.idleCheckAt = next;
+        idleWheel.schedule(client.fd, next);
+    }
+
+    void checkIdle(Client& client, time_t now) {
+        const auto& hb = config.heartbeat;
+        if (isDetachedKey(client.fd)) {
+            if (now - client.detachedAt >= config.sessionGraceSeconds) {
+                if (!config.offline) std::cout << "Sesja gracza " << client.nick << " wygasla." << std::endl;
+                dropSession(client);
+            } else {
+                scheduleIdleCheck(client, now);
+            }
+            return;
+        }
+        const char* reason = nullptr;
+        if (client.nick.empty() && hb.loginTimeout > 0 && now - client.connectedAt >= hb.loginTimeout) {
+            reason = "brak logowania";
+        } else if (hb.idleTimeout > 0 && now - client.lastActivity >= hb.idleTimeout) {
+            reason = "brak odpowiedzi";
+        }
+        if (reason) {
+            if (!config.offline) std::cout << "Zamykam nieaktywne polaczenie " << client.fd << " (" << reason << ")" << std::endl;
+            traffic.idleDisconnects++;
+            handleDisconnect(client.fd, true);
+            return;
+        }
+        if (hb.pingAfter > 0 && !client.pingSent && now - client.lastActivity >= hb.pingAfter) {
+            client.pingSent = true;
+            sendToClient(client.fd, MsgType::PING, "");
+        }
+        // Milczacy klient nie trzyma pustego bufora; przy 100 tys. polaczen
+        // to setki MiB. Nastepny read() zaalokuje go od nowa.
+        if (client.reader.buffered() == 0) client.reader.release();
+        scheduleIdleCheck(client, now);
+    }
+
+    void processIdle(time_t now) {
+        idleWheel.advance(now, [&](int fd, time_t at) {
+            auto it = clients.find(fd);
+            if (it == clients.end() || it->second.idleCheckAt != at) return;
+            checkIdle(it->second, now);
+        });
+    }
+
+    // Flaga w LOGIN oznacza, ze klient przyjmuje skompresowane ramki;
+    // isAcceptedHeader nie przepuszcza jej w innych wiadomosciach od klienta.
+    void handleFrame(Client& client, MsgHeader header, std::string_view body) {
+        if (hasCompressedFlag(header.type)) {
+            header.type = frameType(header.type);
+            client.acceptsCompressed = true;
+        }
+        client.lastActivity = now();
+        client.pingSent = false;
+        processMessage(client, header, body);
+    }
+
+    void processMessage(Client& client, MsgHeader header, std::string_view body) {
+        static constexpr MsgDispatcher<MessageHandler> dispatcher{
+            {MsgType::LOGIN, &GameServer::handleLogin},
+            {MsgType::RESUME, &GameServer::handleResume},
+            {MsgType::CREATE_ROOM, &GameServer::handleCreateRoom},
+            {MsgType::GET_ROOM_LIST, &GameServer::handleGetRoomList},
+            {MsgType::GET_LEADERBOARD, &GameServer::handleGetLeaderboard},
+            {MsgType::JOIN_ROOM, &GameServer::handleJoinRoom},
+            {MsgType::SPECTATE_ROOM, &GameServer::handleSpectateRoom},
+            {MsgType::START_GAME, &GameServer::handleStartGame},
+            {MsgType::SUBMIT_ANSWERS, &GameServer::handleSubmitAnswers},
+            {MsgType::SEND_VOTE, &GameServer::handleSendVote},
+            {MsgType::LEAVE_ROOM, &GameServer::handleLeaveRoom},
+            {MsgType::TOURNAMENT_JOIN, &GameServer::handleTournamentJoin},
+            {MsgType::PING, &GameServer::handlePing},
+            {MsgType::PONG, &GameServer::handlePong},
+        };
+
+        TraceSpan span(msgTypeName(header.type), client.fd);
+        MessageHandler handler = dispatcher.find(header.type);
+        if (!handler || !isValidPayload(header.type, body)) {
+            std::cout << "Niepoprawna wiadomosc od " << client.fd << std::endl;
+            return;
+        }
+        (this->*handler)(client, body);
+    }
+
+    // keepSession: zerwane polaczenie (nie wyrzucenie za bledy), sesja
+    // zalogowanego gracza czeka sessionGraceSeconds na RESUME.
+    void handleDisconnect(int fd, bool keepSession = false) {
+        if (!config.offline) std::cout << "Klient " << fd << " rozlaczyl sie." << std::endl;
+        char keep = keepSession ? 1 : 0;
+        recorder.record(RecordKind::DISCONNECT, fd, MsgType::LOGIN, &keep, 1);
+
+        Client& client = clients[fd];
+        if (client.spectatingRoomId != -1) stopSpectating(client);
+        if (fanoutSockets.erase(fd)) spectatorFanout().release(fd);
+        if (keepSession && config.sessionGraceSeconds > 0 && !client.nick.empty()) {
+            detachSession(fd);
+        } else {
+            dropSession(client);
+        }
+
+        if (!config.offline) close(fd);
+
+        auto it = std::remove_if(poll_fds.begin(), poll_fds.end(), 
+                                 [fd](const struct pollfd& p) { return p.fd == fd; });
+        poll_fds.erase(it, poll_fds.end());
+    }
+
+    uint64_t totalThrottled() const {
+        uint64_t total = 0;
+        for (uint64_t n : traffic.throttled) total += n;
+        return total;
+    }
+
+    void handleInput(int fd) {
+        TraceSpan span("handleInput", fd);
+        Client& client = clients[fd];
+        char* chunk = client.reader.prepare(kReadChunk);
+        ssize_t bytesRead = read(fd, chunk, kReadChunk);
+
+        if (bytesRead <= 0) {
+            handleDisconnect(fd, true);
+            return;
+        }
+        recorder.record(RecordKind::BYTES, fd, MsgType::LOGIN, chunk, bytesRead);
+        client.reader.commit(bytesRead);
+        processInput(client);
+    }
+
+    // Ramki zebrane w buforze klienta, z limitami wiadomosci.
+    void processInput(Client& client) {
+        int fd = client.fd;
+        uint32_t nowMs = monotonicMs();
+        bool abusive = false;
+        MsgHeader header;
+        std::string_view body;
+        FrameReader::Status status;
+        while (!abusive && (status = client.reader.next(MSG_TO_SERVER, header, body)) == FrameReader::Status::FRAME) {
+            MsgType type = frameType(header.type);
+            size_t typeIdx = static_cast<uint8_t>(type);
+            if (!client.rate.buckets[typeIdx].take(rateLimitFor(type), nowMs)) {
+                traffic.throttled[typeIdx]++;
+                if (!client.rate.strikes.take(kStrikeLimit, nowMs)) abusive = true;
+                continue;
+            }
+            handleFrame(client, header, body);
+        }
+        bool valid = abusive || status != FrameReader::Status::INVALID;
+        if (!valid) {
+            traffic.invalidFrames++;
+            if (!config.offline) std::cout << "Niepoprawna ramka od " << fd << ", rozlaczam." << std::endl;
+            handleDisconnect(fd);
+        } else if (abusive) {
+            traffic.abuseDisconnects++;
+            if (!config.offline) std::cout << "Klient " << fd << " przekroczyl limity wiadomosci, rozlaczam"
+                      << " (odrzucone ramki: " << totalThrottled() << ", rozlaczenia: " << traffic.abuseDisconnects << ")" << std::endl;
+            handleDisconnect(fd);
+        } else if (client.reader.capacity() > kReaderKeepBytes && client.reader.buffered() <= kReadChunk) {
+            client.reader.shrink(2 * kReadChunk);
+        }
+    }
+
+    static size_t residentBytes() {
+        size_t pages = 0;
+        size_t resident = 0;
+        FILE* f = fopen("/proc/self/statm", "r");
+        if (!f) return 0;
+        if (fscanf(f, "%zu %zu", &pages, &resident) != 2) resident = 0;
+        fclose(f);
+        return resident * static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    }
+
+    // Wiersz stdin od administratora: "pamiec [N]" albo "zmniejsz".
+    void handleAdminCommand(const std::string& line) {
+        std::istringstream in(line);
+        std::string command;
+        in >> command;
+        if (command.empty()) return;
+        if (command == "pamiec") {
+            size_t top = 10;
+            in >> top;
+            std::cout << memoryReport(top) << std::flush;
+        } else if (command == "zmniejsz") {
+            size_t freed = shrinkBuffers();
+            std::cout << "Zwolniono " << formatBytes(freed) << " z buforow odbiorczych" << std::endl;
+        } else {
+            std::cout << "Komendy: pamiec [N], zmniejsz" << std::endl;
+        }
+    }
+
+    void handleAdminInput() {
+        char buf[512];
+        ssize_t n = read(STDIN_FILENO, buf, sizeof(buf));
+        if (n <= 0) {
+            // Koniec wejscia: konsola przestaje byc obserwowana.
+            auto it = std::remove_if(poll_fds.begin(), poll_fds.end(),
+                                     [](const struct pollfd& p) { return p.fd == STDIN_FILENO; });
+            poll_fds.erase(it, poll_fds.end());
+            return;
+        }
+        adminInput.append(buf, n);
+        size_t pos;
+        while ((pos = adminInput.find('\n')) != std::string::npos) {
+            std::string line = adminInput.substr(0, pos);
+            adminInput.erase(0, pos + 1);
+            handleAdminCommand(line);
+        }
+        if (adminInput.size() > sizeof(buf)) adminInput.clear();
+    }
+
+public:
+    explicit GameServer(const ServerConfig& cfg = ServerConfig())
+        : config(cfg), serverPort(cfg.port), journalPath(cfg.journalFile), verdicts(std::max<uint32_t>(1, cfg.verdictCacheSets)) {
+        seed = config.seed ? config.seed : entropy();
+        tokenState = seed;
+        if (!config.recordFile.empty()) {
+            if (recorder.open(config.recordFile, seed)) {
+                std::cout << "Nagrywanie sesji do " << config.recordFile << " (ziarno " << seed << ")" << std::endl;
+            } else {
+                std::cerr << "Failed to open recording " << config.recordFile << ": " << strerror(errno) << std::endl;
+            }
+        }
+        if (!journalPath.empty()) {
+            if (!journal.open(journalPath)) {
+                std::cerr << "Failed to open journal " << journalPath << ": " << strerror(errno) << std::endl;
+            }
+            recoverFromJournal();
+        }
+        if (!config.statsFile.empty() && !statsStore.open(config.statsFile)) {
+            std::cerr << "Failed to open stats store " << config.statsFile << ": " << strerror(errno) << std::endl;
+        }
+        if (!config.verdictCacheFile.empty() && !config.offline && !verdicts.open(config.verdictCacheFile)) {
+            std::cerr << "Failed to open verdict cache " << config.verdictCacheFile << ": " << strerror(errno) << std::endl;
+        }
+        if (recorder.isOpen() && !config.verdictCacheFile.empty()) {
+            std::cout << "Uwaga: nagranie nie obejmuje pamieci werdyktow, odtworzenie moze sie rozejsc" << std::endl;
+        }
+        if (config.offline) return;
+
+        Tracer::instance().installSignals();
+        traceEnabled = config.traceAtStart;
+
+        serverSock = socket(AF_INET, SOCK_STREAM, 0);
+        if (serverSock < 0) {
+            std::cerr << "Failed to create socket: " << strerror(errno) << std::endl;
+            exit(1);
+        }
+        int opt = 1;
+        setsockopt(serverSock, SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt));
+        
+        struct sockaddr_in addr;
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(serverPort);
+        addr.sin_addr.s_addr = INADDR_ANY;
+        
+        if (bind(serverSock, (struct sockaddr*)&addr, sizeof(addr)) < 0) {
+            std::cerr << "Failed to bind to port " << serverPort << ": " << strerror(errno) << std::endl;
+            close(serverSock);
+            exit(1);
+        }
+        if (listen(serverSock, 10) < 0) {
+            std::cerr << "Failed to listen on socket: " << strerror(errno) << std::endl;
+            close(serverSock);
+            exit(1);
+        }
+        setNonBlocking(serverSock);
+        
+        poll_fds.push_back({serverSock, POLLIN, 0});
+        if (config.adminConsole) poll_fds.push_back({STDIN_FILENO, POLLIN, 0});
+    }
+
+    void run() {
+        std::cout << "Serwer nasluchuje na porcie " << serverPort << std::endl;
+        std::vector<int> ready;
+        while (true) {
+            if (Tracer::instance().dumpIfRequested(config.traceFile)) {
+                std::cout << "Zapisano slad wykonania do " << config.traceFile << std::endl;
+            }
+
+            int ret;
+            {
+                TraceSpan span("poll");
+                ret = poll(poll_fds.data(), poll_fds.size(), 1000);
+            }
+            // Sygnaly sledzenia przerywaja poll.
+            if (ret < 0 && errno == EINTR) continue;
+            if (ret < 0) break;
+
+            if (poll_fds[0].revents & POLLIN) {
+                int newFd = accept(serverSock, nullptr, nullptr);
+                if (newFd >= 0) {
+                    setNonBlocking(newFd);
+                    applyKeepAlive(newFd);
+                    addClient(newFd);
+                    recorder.record(RecordKind::CONNECT, newFd);
+                    poll_fds.push_back({newFd, POLLIN, 0});
+                    std::cout << "Nowe polaczenie: " << newFd << std::endl;
+                }
+            }
+
+            // handleDisconnect usuwa wpisy z poll_fds, wiec najpierw zbieramy
+            // gotowe deskryptory, a potem je obslugujemy.
+            ready.clear();
+            for (size_t i = 1; i < poll_fds.size(); ++i) {
+                if (poll_fds[i].revents & (POLLIN | POLLERR | POLLHUP)) ready.push_back(poll_fds[i].fd);
+            }
+            for (int fd : ready) {
+                if (fd == STDIN_FILENO && config.adminConsole) handleAdminInput();
+                else if (clients.count(fd)) handleInput(fd);
+            }
+
+            processTimers(now());
+            recorder.flush();
+        }
+    }
+
+    void processTimers(time_t now) {
+        TraceSpan span("processTimers");
+        TimerEntry entry;
+        while (timers.popDue(now, entry)) {
+            auto it = rooms.find(entry.roomId);
+            if (it == rooms.end() || it->second.timerGeneration != entry.generation) continue;
+            onRoomTimer(it->second, entry.kind, now);
+        }
+
+        processIdle(now);
+        processTournament(now);
+    }
+
+    size_t roomNameIndexBytes() const {
+        size_t bytes = roomsByName.bucket_count() * sizeof(void*);
+        for (const auto& [name, id] : roomsByName) {
+            bytes += kNodeOverhead + sizeof(std::pair<const std::string, int>) + heapBytes(name);
+        }
+        return bytes;
+    }
+
+    // Szacunek pamieci wedlug struktur oraz N klientow i pokoi zajmujacych
+    // najwiecej.
+    std::string memoryReport(size_t top) const {
+        struct Consumer {
+            size_t bytes;
+            std::string label;
+        };
+        std::vector<Consumer> topClients;
+        std::vector<Consumer> topRooms;
+        size_t clientTotal = 0;
+        size_t readerTotal = 0;
+        size_t detached = 0;
+        for (const auto& [key, client] : clients) {
+            size_t bytes = clientBytes(client);
+            clientTotal += bytes;
+            readerTotal += client.reader.capacity();
+            detached += isDetachedKey(key);
+            topClients.push_back({bytes, (isDetachedKey(key) ? "sesja " : "fd ") + std::to_string(key) + " " + client.nick
+                                         + " (bufor " + formatBytes(client.reader.capacity()) + ")"});
+        }
+        size_t roomTotal = 0;
+        size_t answerTotal = 0;
+        size_t verdictTotal = 0;
+        for (const auto& [id, room] : rooms) {
+            size_t bytes = roomBytes(room);
+            roomTotal += bytes;
+            answerTotal += answerMapBytes(room.playerAnswers) + answerMapBytes(room.playerVotes);
+            verdictTotal += knownVerdictBytes(room);
+            topRooms.push_back({bytes, std::to_string(id) + " " + room.name + " (gracze: " + std::to_string(room.players.size()) + ")"});
+        }
+
+        struct Line {
+            const char* name;
+            size_t count;
+            size_t bytes;
+        };
+        std::vector<Line> lines = {
+            {"klienci", clients.size(), clientTotal},
+            {"pokoje", rooms.size(), roomTotal},
+            {"indeks nazw pokoi", roomsByName.size(), roomNameIndexBytes()},
+            {"timery pokoi", timers.size(), timers.memoryBytes()},
+            {"kolo bezczynnosci", clients.size(), idleWheel.memoryBytes()},
+            {"tablica sesji", sessions.size(), sessions.memoryBytes()},
+            {"pamiec werdyktow", verdicts.size(), verdicts.memoryBytes()},
+            {"statystyki graczy", statsStore.size(), statsStore.memoryBytes()},
+            {"deskryptory poll", poll_fds.size(), heapBytes(poll_fds)},
+        };
+        size_t total = 0;
+        for (const Line& line : lines) total += line.bytes;
+
+        std::ostringstream out;
+        out << "Pamiec (szacunek): " << formatBytes(total) << ", RSS procesu: " << formatBytes(residentBytes()) << "\n";
+        for (const Line& line : lines) {
+            out << "  " << line.name << ": " << line.count << ", " << formatBytes(line.bytes) << "\n";
+        }
+        out << "  w tym bufory odbiorcze: " << formatBytes(readerTotal) << ", sesje odlaczone: " << detached
+            << ", odpowiedzi i glosy: " << formatBytes(answerTotal) << ", werdykty pokoi: " << formatBytes(verdictTotal) << "\n";
+
+        auto printTop = [&](const char* title, std::vector<Consumer>& list) {
+            size_t n = std::min(top, list.size());
+            std::partial_sort(list.begin(), list.begin() + n, list.end(),
+                              [](const Consumer& a, const Consumer& b) { return a.bytes > b.bytes; });
+            out << title << "\n";
+            for (size_t i = 0; i < n; ++i) out << "  " << formatBytes(list[i].bytes) << "  " << list[i].label << "\n";
+        };
+        printTop("Najwiecej zajmuja klienci:", topClients);
+        printTop("Najwiecej zajmuja pokoje:", topRooms);
+        return out.str();
+    }
+
+    // Oddaje puste bufory odbiorcze i zmniejsza przerosniete; zwraca liczbe
+    // zwolnionych bajtow.
+    size_t shrinkBuffers() {
+        size_t freed = 0;
+        for (auto& [key, client] : clients) {
+            size_t before = client.reader.capacity();
+            if (client.reader.buffered() == 0) client.reader.release();
+            else if (before > kReaderKeepBytes) client.reader.shrink(client.reader.buffered() + kReadChunk);
+            freed += before - std::min(before, client.reader.capacity());
+        }
+        return freed;
+    }
+
+    void setOutput(OutputFn fn) {
+        output = std::move(fn);
+    }
+
+    // Tokeny wznowienia wydane w nagranej sesji, w kolejnosci wydania.
+    void replayResumeTokens(std::deque<uint64_t> tokens) {
+        replayTokens = std::move(tokens);
+    }
+
+    void setTime(time_t t) {
+        offlineTime = t;
+        offlineMs = static_cast<int64_t>(t) * 1000;
+    }
+
+    // Zegar z dokladnoscia do milisekund, dla limitow wiadomosci przy
+    // odtwarzaniu nagrania.
+    void setTimeMs(int64_t ms) {
+        offlineTime = static_cast<time_t>(ms / 1000);
+        offlineMs = ms;
+    }
+
+    void connectClient(int fd) {
+        addClient(fd);
+    }
+
+    void disconnectClient(int fd, bool keepSession = true) {
+        if (clients.count(fd)) handleDisconnect(fd, keepSession);
+    }
+
+    // Surowe bajty od klienta offline; przechodza ta sama droga co z gniazda
+    // (bufor, ramkowanie, limity).
+    void receive(int fd, const char* data, size_t n) {
+        auto it = clients.find(fd);
+        if (it == clients.end()) return;
+        it->second.reader.append(data, n);
+        processInput(it->second);
+    }
+
+    // Najblizszy termin, w ktorym processTimers moze cos zrobic (0 - brak).
+    // Symulacja przeskakuje zegarem wprost do niego.
+    time_t nextDeadline() const {
+        time_t next = 0;
+        auto consider = [&](time_t at) {
+            if (at != 0 && (next == 0 || at < next)) next = at;
+        };
+        consider(timers.nextAt());
+        consider(idleWheel.nextDue());
+        consider(tournament.seatAt);
+        if (!tournament.pendingStart.empty()) consider(tournament.startAt);
+        return next;
+    }
+
+    void deliver(int fd, MsgType type, const std::vector<char>& body) {
+        auto it = clients.find(fd);
+        if (it == clients.end()) return;
+        MsgHeader header;
+        header.type = type;
+        header.len = htonl(body.size());
+        handleFrame(it->second, header, std::string_view(body.data(), body.size()));
+    }
+    
+    ~GameServer() {
+        if (serverSock >= 0) close(serverSock);
+    }
+};
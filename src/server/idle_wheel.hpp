@@ -0,0 +1,66 @@
+#pragma once
+#include <ctime>
+#include <vector>
+
+// Kolo czasowe do sprawdzania bezczynnych polaczen: kubelek na kazda sekunde
+// (modulo liczba kubelkow). Aktywnosc klienta tylko przesuwa jego
+// lastActivity; wpis w kole nie jest przenoszony, a przy sprawdzeniu serwer
+// wylicza nastepny termin. Dzieki temu co sekunde oglada sie tylko klientow,
+// ktorych termin wlasnie minal, a nie wszystkich.
+
+class IdleWheel {
+public:
+    struct Entry {
+        int fd;
+        time_t at;
+    };
+
+    explicit IdleWheel(size_t slots = 64) : buckets(slots) {}
+
+    void schedule(int fd, time_t at) {
+        buckets[static_cast<size_t>(at) % buckets.size()].push_back({fd, at});
+    }
+
+    // Wywoluje due(fd, at) dla wpisow z terminem <= now. Wpisy z dalszym
+    // terminem (kolejne okrazenie kola) zostaja w kubelku.
+    template <typename Fn>
+    void advance(time_t now, Fn&& due) {
+        if (lastTick == 0) lastTick = now - 1;
+        time_t from = lastTick + 1;
+        if (now - from >= static_cast<time_t>(buckets.size())) from = now - buckets.size() + 1;
+        lastTick = now;
+
+        for (time_t t = from; t <= now; ++t) {
+            std::vector<Entry> bucket;
+            bucket.swap(buckets[static_cast<size_t>(t) % buckets.size()]);
+            for (const Entry& e : bucket) {
+                if (e.at > now) schedule(e.fd, e.at);
+                else due(e.fd, e.at);
+            }
+        }
+    }
+
+    // Najwczesniejszy termin w kole (0, gdy puste). Kubelki sprawdzane sa po
+    // kolei od nastepnej sekundy, wiec zwykle wystarcza pierwszy niepusty.
+    time_t nextDue() const {
+        time_t best = 0;
+        for (size_t i = 1; i <= buckets.size(); ++i) {
+            time_t t = lastTick + static_cast<time_t>(i);
+            for (const Entry& e : buckets[static_cast<size_t>(t) % buckets.size()]) {
+                if (e.at <= t) return e.at;
+                if (best == 0 || e.at < best) best = e.at;
+            }
+        }
+        return best;
+    }
+
+    size_t memoryBytes() const {
+        size_t bytes = buckets.capacity() * sizeof(buckets[0]);
+        for (const auto& bucket : buckets) bytes += bucket.capacity() * sizeof(Entry);
+        return bytes;
+    }
+
+private:
+    std::vector<std::vector<Entry>> buckets;
+    time_t lastTick = 0;
+};
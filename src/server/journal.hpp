@@ -0,0 +1,206 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <chrono>
+#include <cstring>
+#include <cerrno>
+#include <iostream>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+// Dziennik zdarzen gry (append-only). Rekordy sa dopisywane do bufora w watku
+// reaktora, a osobny watek zapisuje je partiami i robi jeden fdatasync na
+// cala partie (group commit).
+
+enum class JournalEvent : uint8_t {
+    ROOM_CREATE = 1,
+    ROOM_JOIN,
+    ROOM_LEAVE,
+    ROOM_CLOSE,
+    ROUND_START,
+    ANSWERS,
+    VOTE,
+    SCORES,
+    GAME_END
+};
+
+struct JournalRecordHeader {
+    JournalEvent event;
+    uint32_t roomId;
+    uint32_t len;
+    uint32_t checksum;
+} __attribute__((packed));
+
+inline uint32_t journalChecksum(uint32_t h, const char* data, size_t len) {
+    for (size_t i = 0; i < len; ++i) {
+        h ^= static_cast<uint8_t>(data[i]);
+        h *= 16777619u;
+    }
+    return h;
+}
+
+// Suma obejmuje naglowek (z wyzerowanym polem checksum) i dane, wiec
+// uszkodzony typ zdarzenia albo numer pokoju tez przerywa odtwarzanie.
+inline uint32_t journalChecksum(const JournalRecordHeader& header, const char* data) {
+    JournalRecordHeader copy = header;
+    copy.checksum = 0;
+    uint32_t h = journalChecksum(2166136261u, reinterpret_cast<const char*>(&copy), sizeof(copy));
+    return journalChecksum(h, data, header.len);
+}
+
+class Journal {
+public:
+    using ReplayFn = std::function<void(const JournalRecordHeader&, const char*)>;
+
+    ~Journal() {
+        close();
+    }
+
+    bool open(const std::string& path) {
+        fd = ::open(path.c_str(), O_WRONLY | O_APPEND | O_CREAT, 0644);
+        if (fd < 0) return false;
+        running = true;
+        writer = std::thread(&Journal::writerLoop, this);
+        return true;
+    }
+
+    bool isOpen() const {
+        return fd >= 0;
+    }
+
+    // Liczba partii, ktorych nie udalo sie zapisac (i ktore przepadly).
+    size_t failedWrites() const {
+        return failedBatches.load();
+    }
+
+    void append(JournalEvent event, int roomId, const std::string& data) {
+        if (fd < 0) return;
+        JournalRecordHeader header;
+        header.event = event;
+        header.roomId = static_cast<uint32_t>(roomId);
+        header.len = data.size();
+        header.checksum = journalChecksum(header, data.data());
+
+        std::lock_guard<std::mutex> lock(mtx);
+        const char* raw = reinterpret_cast<const char*>(&header);
+        pending.insert(pending.end(), raw, raw + sizeof(header));
+        pending.insert(pending.end(), data.begin(), data.end());
+        if (pending.size() >= flushThreshold) cv.notify_one();
+    }
+
+    void close() {
+        if (fd < 0) return;
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            running = false;
+        }
+        cv.notify_one();
+        writer.join();
+        ::close(fd);
+        fd = -1;
+    }
+
+    // Odtwarza poprawny prefiks dziennika z pliku zmapowanego w pamieci.
+    // Uciety lub uszkodzony ogon (np. po awarii w trakcie zapisu) jest obcinany,
+    // zeby kolejne dopisywane rekordy dalo sie odczytac.
+    static size_t replay(const std::string& path, const ReplayFn& fn) {
+        int rfd = ::open(path.c_str(), O_RDWR);
+        if (rfd < 0) return 0;
+
+        struct stat st;
+        if (fstat(rfd, &st) < 0 || st.st_size == 0) {
+            ::close(rfd);
+            return 0;
+        }
+
+        size_t size = st.st_size;
+        void* map = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, rfd, 0);
+        if (map == MAP_FAILED) {
+            ::close(rfd);
+            return 0;
+        }
+        madvise(map, size, MADV_SEQUENTIAL);
+
+        const char* base = static_cast<const char*>(map);
+        size_t offset = 0;
+        size_t count = 0;
+        while (offset + sizeof(JournalRecordHeader) <= size) {
+            JournalRecordHeader header;
+            std::memcpy(&header, base + offset, sizeof(header));
+            const char* data = base + offset + sizeof(header);
+            if (header.len > size - offset - sizeof(header)) break;
+            if (journalChecksum(header, data) != header.checksum) break;
+            fn(header, data);
+            offset += sizeof(header) + header.len;
+            ++count;
+        }
+
+        munmap(map, size);
+        if (offset < size) {
+            if (ftruncate(rfd, offset) < 0) {}
+        }
+        ::close(rfd);
+        return count;
+    }
+
+private:
+    static constexpr size_t flushThreshold = 64 * 1024;
+    static constexpr auto flushInterval = std::chrono::milliseconds(20);
+
+    int fd = -1;
+    bool running = false;
+    std::thread writer;
+    std::mutex mtx;
+    std::condition_variable cv;
+    std::vector<char> pending;
+    std::atomic<size_t> failedBatches{0};
+
+    bool writeAll(const char* data, size_t size) {
+        size_t written = 0;
+        while (written < size) {
+            ssize_t n = ::write(fd, data + written, size - written);
+            if (n < 0 && errno == EINTR) continue;
+            if (n <= 0) return false;
+            written += n;
+        }
+        return true;
+    }
+
+    void writerLoop() {
+        std::vector<char> batch;
+        std::unique_lock<std::mutex> lock(mtx);
+        while (true) {
+            cv.wait_for(lock, flushInterval, [this] {
+                return !running || pending.size() >= flushThreshold;
+            });
+            bool stop = !running;
+            batch.swap(pending);
+            lock.unlock();
+
+            if (!batch.empty()) {
+                off_t end = lseek(fd, 0, SEEK_END);
+                if (writeAll(batch.data(), batch.size())) {
+                    fdatasync(fd);
+                } else {
+                    // Czesciowo zapisana partia zaslonilaby kolejne rekordy
+                    // przy odtwarzaniu, wiec plik wraca do poprzedniej dlugosci.
+                    failedBatches++;
+                    std::cerr << "Blad zapisu dziennika: " << strerror(errno) << std::endl;
+                    if (end >= 0 && ftruncate(fd, end) < 0) {}
+                }
+                batch.clear();
+            }
+
+            lock.lock();
+            if (stop && pending.empty()) break;
+        }
+    }
+};
@@ -0,0 +1,121 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+// Losowanie liter dla pokoju. Kazdy pokoj ma wlasny generator xoshiro128++
+// (bez wspolnego stanu jak rand()), ziarno wyprowadzone z ziarna serwera i id
+// pokoju, wiec nagranie sesji odtwarza te same litery. Litery maja wagi wedlug
+// tego, jak czesto zaczynaja sie od nich polskie slowa; Q, V, X, Y i litery z
+// ogonkami sa pominiete. W ramach jednej gry litery sie nie powtarzaja.
+
+inline uint64_t splitMix64(uint64_t& state) {
+    uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+class Xoshiro128pp {
+public:
+    void seed(uint64_t value) {
+        uint64_t sm = value;
+        uint64_t a = splitMix64(sm);
+        uint64_t b = splitMix64(sm);
+        s[0] = static_cast<uint32_t>(a);
+        s[1] = static_cast<uint32_t>(a >> 32);
+        s[2] = static_cast<uint32_t>(b);
+        s[3] = static_cast<uint32_t>(b >> 32);
+    }
+
+    uint32_t next() {
+        uint32_t result = rotl(s[0] + s[3], 7) + s[0];
+        uint32_t t = s[1] << 9;
+        s[2] ^= s[0];
+        s[3] ^= s[1];
+        s[1] ^= s[2];
+        s[0] ^= s[3];
+        s[2] ^= t;
+        s[3] = rotl(s[3], 11);
+        return result;
+    }
+
+    // Liczba z [0, bound) bez przesuniecia modulo (metoda Lemire'a).
+    uint32_t below(uint32_t bound) {
+        uint64_t m = static_cast<uint64_t>(next()) * bound;
+        uint32_t low = static_cast<uint32_t>(m);
+        if (low < bound) {
+            uint32_t threshold = -bound % bound;
+            while (low < threshold) {
+                m = static_cast<uint64_t>(next()) * bound;
+                low = static_cast<uint32_t>(m);
+            }
+        }
+        return static_cast<uint32_t>(m >> 32);
+    }
+
+private:
+    uint32_t s[4] = {1, 2, 3, 4};
+
+    static uint32_t rotl(uint32_t x, int k) {
+        return (x << k) | (x >> (32 - k));
+    }
+};
+
+struct LetterWeight {
+    char letter;
+    uint8_t weight;
+};
+
+constexpr LetterWeight kLetterPool[] = {
+    {'P', 12}, {'S', 10}, {'K', 9}, {'M', 7}, {'W', 7}, {'B', 6}, {'D', 6}, {'Z', 6},
+    {'T', 5}, {'G', 5}, {'R', 5}, {'O', 5}, {'L', 4}, {'N', 4}, {'C', 4}, {'A', 4},
+    {'J', 3}, {'H', 2}, {'F', 2}, {'I', 2}, {'E', 1}, {'U', 1},
+};
+constexpr size_t kLetterPoolSize = sizeof(kLetterPool) / sizeof(kLetterPool[0]);
+
+constexpr uint32_t letterPoolWeight() {
+    uint32_t total = 0;
+    for (const auto& entry : kLetterPool) total += entry.weight;
+    return total;
+}
+
+class LetterDraw {
+public:
+    void seed(uint64_t value) {
+        rng.seed(value);
+        reset();
+    }
+
+    // Nowa gra: wszystkie litery znowu dostepne.
+    void reset() {
+        used = 0;
+        remainingWeight = letterPoolWeight();
+    }
+
+    char next() {
+        if (remainingWeight == 0) reset();
+        uint32_t pick = rng.below(remainingWeight);
+        for (size_t i = 0; i < kLetterPoolSize; ++i) {
+            if (used & (1u << i)) continue;
+            if (pick < kLetterPool[i].weight) {
+                used |= 1u << i;
+                remainingWeight -= kLetterPool[i].weight;
+                return kLetterPool[i].letter;
+            }
+            pick -= kLetterPool[i].weight;
+        }
+        return kLetterPool[0].letter;
+    }
+
+private:
+    Xoshiro128pp rng;
+    uint32_t used = 0;
+    uint32_t remainingWeight = letterPoolWeight();
+};
+
+static_assert(kLetterPoolSize <= 32, "LetterDraw trzyma uzyte litery w masce 32-bitowej");
+
+inline uint64_t roomLetterSeed(uint64_t serverSeed, int roomId) {
+    uint64_t state = serverSeed ^ (static_cast<uint64_t>(roomId) * 0xD1B54A32D192ED03ULL);
+    return splitMix64(state);
+}
@@ -0,0 +1,36 @@
+#pragma once
+#include <cstddef>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+// Szacowanie pamieci struktur serwera dla raportu administracyjnego:
+// pojemnosci buforow plus przyblizony narzut wezlow map i zbiorow. Liczby
+// nie uwzgledniaja narzutu alokatora, wiec sa nieco nizsze niz RSS.
+
+// Naglowek wezla std::map/std::set (kolor, rodzic, dzieci) albo wezla listy
+// w std::unordered_map razem z zapamietanym skrotem.
+constexpr size_t kNodeOverhead = 32;
+
+// Tylko pamiec poza obiektem; krotkie napisy mieszcza sie w nim (SSO).
+inline size_t heapBytes(const std::string& s) {
+    return s.capacity() > std::string().capacity() ? s.capacity() + 1 : 0;
+}
+
+template <typename T>
+size_t heapBytes(const std::vector<T>& v) {
+    return v.capacity() * sizeof(T);
+}
+
+inline std::string formatBytes(size_t bytes) {
+    static const char* units[] = {"B", "KiB", "MiB", "GiB"};
+    double value = static_cast<double>(bytes);
+    size_t unit = 0;
+    while (value >= 1024.0 && unit + 1 < sizeof(units) / sizeof(units[0])) {
+        value /= 1024.0;
+        unit++;
+    }
+    char buf[32];
+    std::snprintf(buf, sizeof(buf), unit == 0 ? "%.0f %s" : "%.1f %s", value, units[unit]);
+    return buf;
+}
@@ -0,0 +1,69 @@
+#pragma once
+#include <cstdint>
+#include <array>
+#include <algorithm>
+#include "protocol.hpp"
+
+// Token bucket na liczbach calkowitych: tokeny liczone w tysiecznych,
+// czas w milisekundach od startu serwera.
+
+struct RateLimit {
+    uint32_t perSecond;
+    uint32_t burst;
+};
+
+inline RateLimit rateLimitFor(MsgType type) {
+    switch (type) {
+        case MsgType::LOGIN:           return {1, 3};
+        case MsgType::RESUME:          return {1, 3};
+        case MsgType::GET_ROOM_LIST:   return {2, 5};
+        case MsgType::GET_LEADERBOARD: return {1, 3};
+        case MsgType::CREATE_ROOM:     return {1, 5};
+        case MsgType::JOIN_ROOM:       return {2, 5};
+        case MsgType::SPECTATE_ROOM:   return {2, 5};
+        case MsgType::TOURNAMENT_JOIN: return {1, 3};
+        case MsgType::START_GAME:      return {1, 3};
+        case MsgType::LEAVE_ROOM:      return {2, 5};
+        case MsgType::SUBMIT_ANSWERS:  return {2, 4};
+        case MsgType::SEND_VOTE:       return {2, 4};
+        case MsgType::PING:            return {1, 3};
+        case MsgType::PONG:            return {1, 3};
+        default:                       return {10, 20};
+    }
+}
+
+// Po wyczerpaniu tych "ostrzezen" klient jest rozlaczany.
+constexpr RateLimit kStrikeLimit = {5, 50};
+
+struct TokenBucket {
+    uint32_t milliTokens = 0;
+    uint32_t lastMs = 0;
+    bool started = false;
+
+    bool take(const RateLimit& limit, uint32_t nowMs) {
+        uint32_t capacity = limit.burst * 1000;
+        if (!started) {
+            milliTokens = capacity;
+            lastMs = nowMs;
+            started = true;
+        }
+        uint64_t refill = static_cast<uint64_t>(nowMs - lastMs) * limit.perSecond;
+        milliTokens = static_cast<uint32_t>(std::min<uint64_t>(capacity, milliTokens + refill));
+        lastMs = nowMs;
+        if (milliTokens < 1000) return false;
+        milliTokens -= 1000;
+        return true;
+    }
+};
+
+struct ClientRateState {
+    std::array<TokenBucket, kMsgTypeCount> buckets;
+    TokenBucket strikes;
+};
+
+struct TrafficCounters {
+    std::array<uint64_t, kMsgTypeCount> throttled{};
+    uint64_t invalidFrames = 0;
+    uint64_t abuseDisconnects = 0;
+    uint64_t idleDisconnects = 0;
+};
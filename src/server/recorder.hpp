@@ -0,0 +1,129 @@
+#pragma once
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <chrono>
+#include <string>
+#include <vector>
+#include "protocol.hpp"
+
+// Nagranie sesji serwera: ziarno generatora liter, czas startu oraz kazdy
+// odczyt z gniazda (BYTES, surowe bajty sprzed ramkowania) / polaczenie /
+// rozlaczenie ze znacznikiem czasu monotonicznego. Rozlaczenie niesie jeden
+// bajt: czy sesja gracza czeka na wznowienie (zerwane polaczenie), czy
+// przepada (niepoprawna ramka, przekroczone limity). Losowe tokeny wznowienia
+// nie wynikaja z ziarna, wiec sa zapisywane osobno (TOKEN, 8 bajtow).
+// replay_bench odtwarza nagranie w procesie, bez gniazd; starsze nagrania z
+// gotowymi ramkami (FRAME) tez sie odtwarzaja.
+//
+// Nagranie nie obejmuje stanu pamieci werdyktow (--verdict-cache), a serwer
+// offline jej nie wczytuje. Sesja nagrana z ta pamiecia rozejdzie sie przy
+// odtwarzaniu od pierwszej odpowiedzi ocenionej z pamieci.
+
+enum class RecordKind : uint8_t {
+    CONNECT = 1,
+    FRAME,
+    DISCONNECT,
+    TOKEN,
+    BYTES
+};
+
+struct RecordingHeader {
+    char magic[4];
+    uint32_t seed;
+    int64_t startTime;
+} __attribute__((packed));
+
+struct RecordEntryHeader {
+    RecordKind kind;
+    int32_t conn;
+    uint64_t timestampNs;
+    MsgType type;
+    uint32_t len;
+} __attribute__((packed));
+
+struct RecordedEntry {
+    RecordKind kind;
+    int conn;
+    uint64_t timestampNs;
+    MsgType type;
+    std::vector<char> body;
+};
+
+struct Recording {
+    uint32_t seed = 0;
+    time_t startTime = 0;
+    std::vector<RecordedEntry> entries;
+};
+
+class SessionRecorder {
+public:
+    ~SessionRecorder() {
+        if (file) fclose(file);
+    }
+
+    bool open(const std::string& path, uint32_t seed) {
+        file = fopen(path.c_str(), "wb");
+        if (!file) return false;
+        start = std::chrono::steady_clock::now();
+        RecordingHeader header;
+        std::memcpy(header.magic, "PMR1", 4);
+        header.seed = seed;
+        header.startTime = time(NULL);
+        fwrite(&header, sizeof(header), 1, file);
+        return true;
+    }
+
+    bool isOpen() const {
+        return file != nullptr;
+    }
+
+    void record(RecordKind kind, int conn, MsgType type = MsgType::LOGIN, const char* data = nullptr, uint32_t len = 0) {
+        if (!file) return;
+        RecordEntryHeader header;
+        header.kind = kind;
+        header.conn = conn;
+        header.timestampNs = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - start).count();
+        header.type = type;
+        header.len = len;
+        fwrite(&header, sizeof(header), 1, file);
+        if (len > 0) fwrite(data, 1, len, file);
+        dirty = true;
+    }
+
+    void flush() {
+        if (file && dirty) {
+            fflush(file);
+            dirty = false;
+        }
+    }
+
+    static bool load(const std::string& path, Recording& out) {
+        FILE* f = fopen(path.c_str(), "rb");
+        if (!f) return false;
+
+        RecordingHeader header;
+        if (fread(&header, sizeof(header), 1, f) != 1 || std::memcmp(header.magic, "PMR1", 4) != 0) {
+            fclose(f);
+            return false;
+        }
+        out.seed = header.seed;
+        out.startTime = header.startTime;
+
+        RecordEntryHeader eh;
+        while (fread(&eh, sizeof(eh), 1, f) == 1) {
+            RecordedEntry entry{eh.kind, eh.conn, eh.timestampNs, eh.type, std::vector<char>(eh.len)};
+            if (eh.len > 0 && fread(entry.body.data(), 1, eh.len, f) != eh.len) break;
+            out.entries.push_back(std::move(entry));
+        }
+        fclose(f);
+        return true;
+    }
+
+private:
+    FILE* file = nullptr;
+    std::chrono::steady_clock::time_point start;
+    bool dirty = false;
+};
@@ -0,0 +1,153 @@
+#include "game_server.hpp"
+#include <chrono>
+
+namespace {
+
+// Idzie po surowym strumieniu jednego polaczenia i liczy ramki; z flagLogin
+// ustawia bit kompresji w typie kazdej ramki LOGIN. Naglowek moze byc
+// rozciety miedzy odczytami.
+struct StreamScanner {
+    uint32_t bodyLeft = 0;
+    size_t headerFill = 0;
+    char header[sizeof(MsgHeader)];
+
+    size_t apply(std::vector<char>& bytes, bool flagLogin) {
+        size_t frames = 0;
+        size_t i = 0;
+        while (i < bytes.size()) {
+            if (bodyLeft > 0) {
+                size_t skip = std::min<size_t>(bodyLeft, bytes.size() - i);
+                bodyLeft -= skip;
+                i += skip;
+                continue;
+            }
+            if (flagLogin && headerFill == 0 && frameType(static_cast<MsgType>(bytes[i])) == MsgType::LOGIN) {
+                bytes[i] = static_cast<char>(static_cast<uint8_t>(MsgType::LOGIN) | kFrameFlagCompressed);
+            }
+            header[headerFill++] = bytes[i++];
+            if (headerFill == sizeof(MsgHeader)) {
+                MsgHeader h;
+                std::memcpy(&h, header, sizeof(h));
+                bodyLeft = ntohl(h.len);
+                headerFill = 0;
+                frames++;
+            }
+        }
+        return frames;
+    }
+};
+
+}
+
+int main(int argc, char** argv) {
+    std::vector<std::string> args;
+    bool compress = false;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--compress") compress = true;
+        else args.push_back(arg);
+    }
+    if (args.empty()) {
+        std::cerr << "Uzycie: " << argv[0] << " <nagranie> [powtorzenia] [--compress]" << std::endl;
+        return 1;
+    }
+
+    Recording recording;
+    if (!SessionRecorder::load(args[0], recording)) {
+        std::cerr << "Nie mozna wczytac nagrania " << args[0] << std::endl;
+        return 1;
+    }
+    int iterations = args.size() >= 2 ? std::max(1, std::atoi(args[1].c_str())) : 1;
+
+    // Ramki w nagraniu sa liczone raz, przed pomiarem. --compress: wszyscy
+    // klienci z nagrania zglaszaja w LOGIN obsluge kompresji, co pozwala
+    // porownac ruch wyjsciowy z kompresja i bez niej.
+    size_t recordedFrames = 0;
+    std::map<int, StreamScanner> streams;
+    for (auto& entry : recording.entries) {
+        if (entry.kind == RecordKind::CONNECT) {
+            streams[entry.conn] = StreamScanner{};
+        } else if (entry.kind == RecordKind::BYTES) {
+            recordedFrames += streams[entry.conn].apply(entry.body, compress);
+        } else if (entry.kind == RecordKind::FRAME) {
+            recordedFrames++;
+            if (compress && frameType(entry.type) == MsgType::LOGIN) {
+                entry.type = static_cast<MsgType>(static_cast<uint8_t>(MsgType::LOGIN) | kFrameFlagCompressed);
+            }
+        }
+    }
+
+    std::deque<uint64_t> tokens;
+    for (const auto& entry : recording.entries) {
+        if (entry.kind != RecordKind::TOKEN || entry.body.size() != sizeof(uint64_t)) continue;
+        uint64_t token;
+        std::memcpy(&token, entry.body.data(), sizeof(token));
+        tokens.push_back(token);
+    }
+
+    size_t framesIn = recordedFrames * iterations;
+    size_t bytesIn = 0;
+    size_t framesOut = 0;
+    size_t bytesOut = 0;
+    std::chrono::nanoseconds elapsed{0};
+
+    for (int iter = 0; iter < iterations; ++iter) {
+        ServerConfig config;
+        config.offline = true;
+        config.seed = recording.seed;
+        // Serwer powstaje od nowa w kazdym powtorzeniu; do krotkiego nagrania
+        // wystarczy mala pamiec werdyktow.
+        config.verdictCacheSets = 64;
+        GameServer server(config);
+        server.replayResumeTokens(tokens);
+        server.setOutput([&](int, const std::vector<char>& frame) {
+            framesOut++;
+            bytesOut += frame.size();
+        });
+
+        time_t clock = recording.startTime;
+        server.setTime(clock);
+
+        auto start = std::chrono::steady_clock::now();
+        for (const auto& entry : recording.entries) {
+            time_t at = recording.startTime + static_cast<time_t>(entry.timestampNs / 1000000000ULL);
+            while (clock < at) {
+                server.setTime(++clock);
+                server.processTimers(clock);
+            }
+            // Limity wiadomosci licza milisekundy, wiec zegar idzie dokladnie
+            // za znacznikiem wpisu.
+            server.setTimeMs(static_cast<int64_t>(recording.startTime) * 1000
+                             + static_cast<int64_t>(entry.timestampNs / 1000000ULL));
+
+            switch (entry.kind) {
+                case RecordKind::CONNECT:
+                    server.connectClient(entry.conn);
+                    break;
+                case RecordKind::BYTES:
+                    server.receive(entry.conn, entry.body.data(), entry.body.size());
+                    bytesIn += entry.body.size();
+                    break;
+                case RecordKind::FRAME:
+                    server.deliver(entry.conn, entry.type, entry.body);
+                    break;
+                case RecordKind::DISCONNECT:
+                    // Starsze nagrania nie maja bajtu z rodzajem rozlaczenia.
+                    server.disconnectClient(entry.conn, entry.body.empty() || entry.body[0] != 0);
+                    break;
+                case RecordKind::TOKEN:
+                    break;
+            }
+        }
+        elapsed += std::chrono::steady_clock::now() - start;
+    }
+
+    double seconds = std::chrono::duration<double>(elapsed).count();
+    std::cout << "Ziarno: " << recording.seed << ", zdarzen: " << recording.entries.size()
+              << ", powtorzen: " << iterations << std::endl;
+    std::cout << "Ramki wejsciowe: " << framesIn << " (" << bytesIn << " B), wyjsciowe: " << framesOut
+              << " (" << bytesOut << " B)" << std::endl;
+    std::cout << "Czas: " << seconds * 1000.0 << " ms, "
+              << (seconds > 0 ? framesIn / seconds : 0.0) << " ramek/s" << std::endl;
+    return 0;
+}
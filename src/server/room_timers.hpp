@@ -0,0 +1,63 @@
+#pragma once
+#include <cstdint>
+#include <ctime>
+#include <queue>
+#include <vector>
+
+// Jedna kolejka priorytetowa terminow dla wszystkich pokoi. Wpis niesie
+// numer generacji pokoju z chwili zaplanowania; zmiana fazy zwieksza
+// generacje, wiec stare wpisy nie sa usuwane, tylko pomijane przy zdjeciu.
+
+enum class RoomTimer : uint8_t {
+    TICK,      // odliczanie TIME_LEFT co sekunde
+    DEADLINE,  // koniec biezacej fazy
+    GRACE      // po TIME_UP: ostatnia chwila na odpowiedzi spoznionych klientow
+};
+
+struct TimerEntry {
+    time_t at;
+    uint64_t seq;
+    int roomId;
+    uint32_t generation;
+    RoomTimer kind;
+};
+
+class TimerQueue {
+public:
+    void push(time_t at, int roomId, uint32_t generation, RoomTimer kind) {
+        heap.push(TimerEntry{at, nextSeq++, roomId, generation, kind});
+    }
+
+    // Zdejmuje najwczesniejszy wpis, jesli jego termin juz minal.
+    bool popDue(time_t now, TimerEntry& out) {
+        if (heap.empty() || heap.top().at > now) return false;
+        out = heap.top();
+        heap.pop();
+        return true;
+    }
+
+    // Termin najwczesniejszego wpisu (0, gdy kolejka pusta); nieaktualne
+    // wpisy tez sie licza, wiec to najwyzej za wczesna pobudka.
+    time_t nextAt() const {
+        return heap.empty() ? 0 : heap.top().at;
+    }
+
+    size_t size() const {
+        return heap.size();
+    }
+
+    // priority_queue nie zdradza pojemnosci, wiec to dolne oszacowanie.
+    size_t memoryBytes() const {
+        return heap.size() * sizeof(TimerEntry);
+    }
+
+private:
+    struct Later {
+        bool operator()(const TimerEntry& a, const TimerEntry& b) const {
+            return a.at != b.at ? a.at > b.at : a.seq > b.seq;
+        }
+    };
+
+    std::priority_queue<TimerEntry, std::vector<TimerEntry>, Later> heap;
+    uint64_t nextSeq = 0;
+};
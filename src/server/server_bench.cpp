@@ -0,0 +1,225 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <functional>
+#include <iostream>
+#include "protocol.hpp"
+#include "frame_reader.hpp"
+#include "compression.hpp"
+#include "game_logic.hpp"
+#include "session_table.hpp"
+#include "verdict_cache.hpp"
+
+// Prosty harness: kazdy przypadek jest powtarzany, az zajmie ~200 ms,
+// a wyniki sa wypisywane jako JSON (do porownywania miedzy commitami).
+
+static volatile size_t benchSink;
+
+struct BenchResult {
+    std::string name;
+    size_t iterations;
+    double nsPerOp;
+    size_t bytesIn = 0;
+    size_t bytesOut = 0;
+};
+
+static BenchResult runBench(const std::string& name, const std::function<size_t()>& fn) {
+    using clock = std::chrono::steady_clock;
+    const auto target = std::chrono::milliseconds(200);
+
+    size_t iterations = 1;
+    while (true) {
+        auto start = clock::now();
+        size_t acc = 0;
+        for (size_t i = 0; i < iterations; ++i) acc += fn();
+        auto elapsed = clock::now() - start;
+        benchSink = acc;
+        if (elapsed >= target || iterations >= (size_t(1) << 30)) {
+            double ns = std::chrono::duration<double, std::nano>(elapsed).count();
+            return {name, iterations, ns / iterations, 0, 0};
+        }
+        iterations *= elapsed < target / 10 ? 10 : 2;
+    }
+}
+
+static const char* words[][5] = {
+    {"Polska", "Poznan", "Pies", "Pomidor", "Pilka"},
+    {"Peru", "Paryz", "Pantera", "Pietruszka", "Patelnia"},
+    {"Portugalia", "Praga", "Papuga", "Por", "Parasol"},
+    {"Pakistan", "Pekin", "Pingwin", "Paproc", "Pedzel"},
+};
+
+static Room makeRoom(int players, const RuleSet& rules = defaultRules()) {
+    Room room;
+    room.id = 1;
+    room.name = "bench";
+    room.hostFd = 0;
+    room.rules = &rules;
+    for (int p = 0; p < players; ++p) {
+        room.players.push_back(p);
+        std::string answers;
+        for (size_t c = 0; c < rules.categoryCount(); ++c) {
+            if (c) answers += ";";
+            answers += words[(p + c) % 4][c % 5];
+            if (c >= 5) answers += "x";
+            if (p % 3 == 0) answers += std::to_string(p);
+        }
+        room.playerAnswers[p] = answers;
+        room.playerVotes[p] = "0:Peru;2:Papuga;";
+    }
+    return room;
+}
+
+int main(int argc, char** argv) {
+    std::string filter = argc >= 2 ? argv[1] : "";
+    std::vector<BenchResult> results;
+    auto bench = [&](const std::string& name, const std::function<size_t()>& fn) {
+        if (!filter.empty() && name.find(filter) == std::string::npos) return;
+        results.push_back(runBench(name, fn));
+    };
+
+    std::vector<char> frames;
+    for (int i = 0; i < 64; ++i) {
+        auto msg = createMessage(MsgType::SUBMIT_ANSWERS, "Polska;Poznan;Pies;Pomidor;Pilka");
+        frames.insert(frames.end(), msg.begin(), msg.end());
+    }
+    FrameReader reader;
+    bench("parse_frames/64", [&] {
+        reader.append(frames.data(), frames.size());
+        size_t n = 0;
+        MsgHeader header;
+        std::string_view body;
+        while (reader.next(MSG_TO_SERVER, header, body) == FrameReader::Status::FRAME) n += body.size();
+        return n;
+    });
+    // Ramki porozcinane na kawalki po 100 B, jak przy wolnym laczu.
+    bench("parse_frames/64_split", [&] {
+        size_t n = 0;
+        MsgHeader header;
+        std::string_view body;
+        for (size_t off = 0; off < frames.size(); off += 100) {
+            reader.append(frames.data() + off, std::min<size_t>(100, frames.size() - off));
+            while (reader.next(MSG_TO_SERVER, header, body) == FrameReader::Status::FRAME) n += body.size();
+        }
+        return n;
+    });
+
+    std::string payload(64, 'x');
+    bench("create_message/64B", [&] {
+        return createMessage(MsgType::ROUND_END, payload).size();
+    });
+
+    std::string answerLine = "Polska;Poznan;Pies;Pomidor;Pilka";
+    bench("split/5", [&] {
+        return split(answerLine, ';').size();
+    });
+
+    LetterDraw letters;
+    letters.seed(roomLetterSeed(42, 1));
+    bench("letter_draw", [&] {
+        letters.reset();
+        return static_cast<size_t>(letters.next());
+    });
+
+    for (int n : {4, 16, 64, 256}) {
+        Room room = makeRoom(n);
+        bench("calculate_scores/" + std::to_string(n), [&] {
+            return scoreRound(room).size();
+        });
+        bench("submit_aggregation/" + std::to_string(n), [&] {
+            return buildVerificationPayload(*room.rules, room.playerAnswers).size();
+        });
+    }
+
+    // Ten sam pokoj z dwukrotnie wieksza liczba kategorii: czas na odpowiedz
+    // powinien byc taki jak w calculate_scores/N.
+    for (int n : {16, 64}) {
+        Room room = makeRoom(n, *findRules("rozszerzone"));
+        bench("calculate_scores_wide/" + std::to_string(n), [&] {
+            return scoreRound(room).size();
+        });
+    }
+
+    // Kompresja duzych ramek: czas jednej kompresji oraz rozmiar przed i po
+    // (bytes_in / bytes_out) dla typowych ladunkow z duzych pokoi.
+    auto compressCase = [&](const std::string& name, MsgType type, const std::string& data) {
+        if (!filter.empty() && name.find(filter) == std::string::npos) return;
+        std::vector<char> frame;
+        BenchResult result = runBench(name, [&] {
+            return compressFrame(type, data, frame) ? frame.size() : 0;
+        });
+        result.bytesIn = sizeof(MsgHeader) + data.size();
+        result.bytesOut = compressFrame(type, data, frame) ? frame.size() : result.bytesIn;
+        results.push_back(result);
+    };
+    for (int n : {16, 64, 256}) {
+        Room room = makeRoom(n);
+        compressCase("compress_verification/" + std::to_string(n), MsgType::VERIFICATION_START,
+                     buildVerificationPayload(*room.rules, room.playerAnswers));
+        std::string summary;
+        for (int p = 0; p < n; ++p) summary += "gracz" + std::to_string(p) + ":" + std::to_string(p * 5 % 150) + ";";
+        compressCase("compress_game_end/" + std::to_string(n), MsgType::GAME_END, summary);
+    }
+
+    // Pamiec werdyktow: normalizacja slowa, skrot i przejrzenie jednego zbioru.
+    VerdictCache verdictCache;
+    std::vector<std::string> cachedWords;
+    for (int i = 0; i < 20000; ++i) {
+        cachedWords.push_back("Miasto" + std::to_string(i));
+        verdictCache.record("Miasto", 'M', cachedWords.back(), i % 4 != 0, i);
+    }
+    size_t nextWord = 0;
+    bench("verdict_lookup", [&] {
+        return static_cast<size_t>(verdictCache.lookup("Miasto", 'M', cachedWords[nextWord++ % cachedWords.size()]));
+    });
+
+    // Wznowienie sesji: odszukanie tokenu i przepiecie go na nowy deskryptor.
+    for (int n : {1000, 100000}) {
+        SessionTable sessions;
+        std::vector<uint64_t> tokens;
+        uint64_t state = 42;
+        for (int i = 0; i < n; ++i) {
+            tokens.push_back(splitMix64(state));
+            sessions.set(tokens.back(), -2 - i);
+        }
+        size_t next = 0;
+        bench("session_resume/" + std::to_string(n), [&] {
+            uint64_t token = tokens[next++ % tokens.size()];
+            int key = sessions.find(token);
+            sessions.set(token, key < 0 ? static_cast<int>(next) : -2 - static_cast<int>(next));
+            return static_cast<size_t>(key & 1);
+        });
+    }
+
+    for (int m : {100, 1000, 10000}) {
+        std::map<int, Room> rooms;
+        for (int id = 1; id <= m; ++id) {
+            Room room;
+            room.id = id;
+            room.name = "Pokoj " + std::to_string(id);
+            room.hostFd = id;
+            room.players = {id, id + 1, id + 2};
+            room.phase = id % 2 ? RoomPhase::ANSWERING : RoomPhase::LOBBY;
+            rooms[id] = room;
+        }
+        bench("room_list/" + std::to_string(m), [&] {
+            return buildRoomList(rooms).size();
+        });
+        compressCase("compress_room_list/" + std::to_string(m), MsgType::ROOM_LIST, buildRoomList(rooms));
+    }
+
+    std::cout << "{\n  \"benchmarks\": [\n";
+    for (size_t i = 0; i < results.size(); ++i) {
+        char line[256];
+        char bytes[96] = "";
+        if (results[i].bytesIn) {
+            snprintf(bytes, sizeof(bytes), ", \"bytes_in\": %zu, \"bytes_out\": %zu", results[i].bytesIn, results[i].bytesOut);
+        }
+        snprintf(line, sizeof(line), "    {\"name\": \"%s\", \"iterations\": %zu, \"ns_per_op\": %.1f%s}%s\n",
+                 results[i].name.c_str(), results[i].iterations, results[i].nsPerOp, bytes,
+                 i + 1 < results.size() ? "," : "");
+        std::cout << line;
+    }
+    std::cout << "  ]\n}" << std::endl;
+    return 0;
+}
@@ -0,0 +1,86 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Tablica tokenow wznowienia: token -> klucz klienta w GameServer::clients
+// (deskryptor albo ujemny klucz sesji odlaczonej). Adresowanie otwarte z
+// sondowaniem liniowym w jednym wektorze, bez alokacji na wpis, wiec fala
+// wznowien po chwilowej awarii sieci to tylko kilka odczytow z pamieci na
+// klienta. Token 0 oznacza pusty slot.
+
+class SessionTable {
+public:
+    static constexpr int kNotFound = -1;
+
+    SessionTable() : slots(16) {}
+
+    void set(uint64_t token, int key) {
+        if ((count + 1) * 4 > slots.size() * 3) grow();
+        size_t i = indexOf(token);
+        if (slots[i].token == 0) {
+            slots[i].token = token;
+            count++;
+        }
+        slots[i].key = key;
+    }
+
+    int find(uint64_t token) const {
+        if (token == 0) return kNotFound;
+        const Slot& slot = slots[indexOf(token)];
+        return slot.token == token ? slot.key : kNotFound;
+    }
+
+    // Usuwanie z przesunieciem wstecz, bez nagrobkow.
+    void erase(uint64_t token) {
+        if (token == 0) return;
+        size_t i = indexOf(token);
+        if (slots[i].token != token) return;
+        size_t mask = slots.size() - 1;
+        size_t j = i;
+        while (true) {
+            j = (j + 1) & mask;
+            if (slots[j].token == 0) break;
+            size_t home = slots[j].token & mask;
+            bool between = i <= j ? (i < home && home <= j) : (i < home || home <= j);
+            if (between) continue;
+            slots[i] = slots[j];
+            i = j;
+        }
+        slots[i] = Slot{};
+        count--;
+    }
+
+    size_t size() const {
+        return count;
+    }
+
+    size_t memoryBytes() const {
+        return slots.capacity() * sizeof(Slot);
+    }
+
+private:
+    struct Slot {
+        uint64_t token = 0;
+        int key = kNotFound;
+    };
+
+    std::vector<Slot> slots;
+    size_t count = 0;
+
+    size_t indexOf(uint64_t token) const {
+        size_t mask = slots.size() - 1;
+        size_t i = token & mask;
+        while (slots[i].token != 0 && slots[i].token != token) i = (i + 1) & mask;
+        return i;
+    }
+
+    void grow() {
+        std::vector<Slot> old(slots.size() * 2);
+        old.swap(slots);
+        count = 0;
+        for (const Slot& slot : old) {
+            if (slot.token != 0) set(slot.token, slot.key);
+        }
+    }
+};
@@ -0,0 +1,267 @@
+#include "game_server.hpp"
+#include "../client_core/game_client.hpp"
+#include <chrono>
+
+// Symulacja wielu gier naraz na zegarze wirtualnym: serwer dziala w trybie
+// offline, a gracze to GameClient polaczeni z nim w pamieci. Zegar nie
+// czeka, tylko przeskakuje do najblizszego terminu serwera (nextDeadline),
+// wiec gra trwajaca minuty zajmuje ulamek milisekundy. Gracze odpowiadaja i
+// glosuja od razu, zatem czas gry wyznaczaja przerwy miedzy rundami.
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// Poczatek czasu wirtualnego; dowolna chwila, byle daleko od zera.
+constexpr time_t kSimEpoch = 1000000000;
+
+struct SimConfig {
+    uint64_t games = 1000;
+    int rooms = 256;     // tyle gier toczy sie jednoczesnie
+    int roomSize = 4;
+    std::string rules = "klasyczne";
+    uint32_t seed = 1;
+    int stallSeconds = 600;  // tyle sekund wirtualnych bez konca gry to zakleszczenie
+};
+
+struct SimPlayer {
+    int fd = 0;
+    int group = 0;
+    bool host = false;
+    bool queued = false;
+    GameClient client;
+};
+
+struct SimGroup {
+    int generation = 0;
+    std::string roomName;
+};
+
+class Simulation {
+public:
+    explicit Simulation(const SimConfig& cfg) : config(cfg), server(serverConfig(cfg)) {
+        int groups = static_cast<int>(std::min<uint64_t>(config.rooms, config.games));
+        groupState.resize(groups);
+        players.resize(static_cast<size_t>(groups) * config.roomSize);
+        for (size_t i = 0; i < players.size(); ++i) {
+            SimPlayer& player = players[i];
+            player.fd = static_cast<int>(i) + 1;
+            player.group = static_cast<int>(i) / config.roomSize;
+            player.host = i % config.roomSize == 0;
+            player.client.setHandler([this, &player](GameClient&, const GameClient::Event& event) { onEvent(player, event); });
+        }
+        gamesScheduled = groups;
+
+        server.setOutput([this](int fd, const std::vector<char>& frame) {
+            framesOut++;
+            SimPlayer& player = players[fd - 1];
+            player.client.receive(frame.data(), frame.size());
+            markDirty(player);
+        });
+    }
+
+    bool run() {
+        clock = kSimEpoch;
+        server.setTime(clock);
+        for (SimPlayer& player : players) {
+            server.connectClient(player.fd);
+            player.client.connected();
+            player.client.login("sim" + std::to_string(player.fd), false);
+            markDirty(player);
+        }
+
+        time_t lastProgress = clock;
+        uint64_t lastFinished = 0;
+        while (gamesFinished < config.games) {
+            drain();
+            if (gamesFinished != lastFinished) {
+                lastFinished = gamesFinished;
+                lastProgress = clock;
+            } else if (clock - lastProgress > config.stallSeconds) {
+                return false;
+            }
+
+            time_t next = server.nextDeadline();
+            if (next == 0) return false;
+            clock = std::max(next, clock + 1);
+            server.setTime(clock);
+
+            auto start = Clock::now();
+            server.processTimers(clock);
+            auto took = Clock::now() - start;
+            timerTime += took;
+            maxStep = std::max<Clock::duration>(maxStep, took);
+            steps++;
+        }
+        drain();
+        return true;
+    }
+
+    void report(Clock::duration elapsed) const {
+        uint64_t framesIn = 0;
+        for (const SimPlayer& player : players) framesIn += player.client.framesSentCount();
+        double seconds = std::chrono::duration<double>(elapsed).count();
+        double simulated = static_cast<double>(clock - kSimEpoch);
+        auto ms = [](Clock::duration d) { return std::chrono::duration<double, std::milli>(d).count(); };
+
+        std::cout << "Gry: " << gamesFinished << " (pokoi naraz: " << groupState.size() << ", graczy: " << players.size()
+                  << ", zasady: " << config.rules << "), bledy: " << failures << std::endl;
+        std::cout << "Ramki do serwera: " << framesIn << ", od serwera: " << framesOut << std::endl;
+        std::cout << "Czas wirtualny: " << simulated << " s w " << steps << " krokach, rzeczywisty: " << seconds * 1000.0
+                  << " ms (" << (seconds > 0 ? gamesFinished / seconds : 0.0) << " gier/s, x"
+                  << (seconds > 0 ? simulated / seconds : 0.0) << ")" << std::endl;
+        std::cout << "Obsluga ramek: " << ms(inputTime) << " ms, timery: " << ms(timerTime)
+                  << " ms, najdluzszy krok timerow: " << ms(maxStep) << " ms" << std::endl;
+    }
+
+    time_t simulatedSeconds() const {
+        return clock - kSimEpoch;
+    }
+
+private:
+    SimConfig config;
+    GameServer server;
+    std::vector<SimPlayer> players;
+    std::vector<SimGroup> groupState;
+    std::vector<int> dirty;
+    std::vector<char> scratch;
+    time_t clock = 0;
+    uint64_t gamesScheduled = 0;
+    uint64_t gamesFinished = 0;
+    uint64_t framesOut = 0;
+    uint64_t failures = 0;
+    uint64_t steps = 0;
+    Clock::duration inputTime{0};
+    Clock::duration timerTime{0};
+    Clock::duration maxStep{0};
+
+    static ServerConfig serverConfig(const SimConfig& cfg) {
+        ServerConfig config;
+        config.offline = true;
+        config.seed = cfg.seed;
+        return config;
+    }
+
+    void markDirty(SimPlayer& player) {
+        if (player.queued || player.client.pendingOutput().empty()) return;
+        player.queued = true;
+        dirty.push_back(player.fd);
+    }
+
+    // Przekazuje serwerowi wszystko, co wyslali gracze, az do ciszy. Serwer
+    // odpowiada synchronicznie przez setOutput, wiec kolejne porcje trafiaja
+    // do dirty w trakcie petli. Wyjscie gracza jest kopiowane przed
+    // przekazaniem, bo odpowiedz (np. PONG) moze dopisac sie do jego bufora.
+    void drain() {
+        auto start = Clock::now();
+        std::vector<int> batch;
+        while (!dirty.empty()) {
+            batch.swap(dirty);
+            for (int fd : batch) {
+                SimPlayer& player = players[fd - 1];
+                player.queued = false;
+                std::string_view out = player.client.pendingOutput();
+                scratch.assign(out.begin(), out.end());
+                player.client.consumeOutput(out.size());
+                server.receive(fd, scratch.data(), scratch.size());
+            }
+            batch.clear();
+        }
+        inputTime += Clock::now() - start;
+    }
+
+    void createRoom(SimPlayer& host) {
+        SimGroup& group = groupState[host.group];
+        group.roomName = "sim-" + std::to_string(host.group) + "-" + std::to_string(group.generation++);
+        host.client.createRoom(group.roomName, config.rules);
+    }
+
+    void onEvent(SimPlayer& player, const GameClient::Event& event) {
+        GameClient& client = player.client;
+        switch (event.type) {
+            case MsgType::LOGIN_OK:
+                if (player.host) createRoom(player);
+                break;
+            case MsgType::CREATE_ROOM_OK: {
+                size_t first = static_cast<size_t>(player.group) * config.roomSize;
+                for (size_t i = first + 1; i < first + config.roomSize; ++i) {
+                    players[i].client.joinRoom(groupState[player.group].roomName);
+                    markDirty(players[i]);
+                }
+                break;
+            }
+            case MsgType::NEW_PLAYER_JOINED:
+                if (client.isHost() && static_cast<int>(client.players().size()) >= config.roomSize) client.startGame();
+                break;
+            case MsgType::GAME_STARTED: {
+                std::vector<std::string> answers;
+                for (const std::string& category : client.categories()) {
+                    answers.push_back(std::string(1, client.letter()) + category.substr(0, 3) + std::to_string(player.fd % 3));
+                }
+                client.submitAnswers(answers);
+                break;
+            }
+            case MsgType::VERIFICATION_START: {
+                std::vector<std::pair<size_t, std::string>> vetoes;
+                const auto& categories = client.verification();
+                for (size_t c = 0; c < categories.size(); ++c) {
+                    const auto& category = categories[c];
+                    for (size_t i = 0; i < category.answers.size(); ++i) {
+                        bool known = i < category.verdicts.size() && category.verdicts[i] != '?';
+                        if (!known && category.answers[i].back() == '2') vetoes.emplace_back(c, category.answers[i]);
+                    }
+                }
+                client.sendVotes(vetoes);
+                break;
+            }
+            case MsgType::GAME_END:
+                if (!player.host) break;
+                gamesFinished++;
+                if (gamesScheduled < config.games) {
+                    gamesScheduled++;
+                    createRoom(player);
+                }
+                break;
+            case MsgType::LOGIN_FAIL:
+            case MsgType::CREATE_ROOM_FAIL:
+            case MsgType::JOIN_ROOM_FAIL:
+            case MsgType::GAME_START_FAIL:
+            case MsgType::HOST_LEFT:
+                failures++;
+                break;
+            default:
+                break;
+        }
+    }
+};
+
+}
+
+int main(int argc, char** argv) {
+    SimConfig config;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--games" && hasValue) config.games = std::max(1LL, std::atoll(argv[++i]));
+        else if (arg == "--rooms" && hasValue) config.rooms = std::max(1, std::atoi(argv[++i]));
+        else if (arg == "--room-size" && hasValue) config.roomSize = std::max(2, std::atoi(argv[++i]));
+        else if (arg == "--rules" && hasValue) config.rules = argv[++i];
+        else if (arg == "--seed" && hasValue) config.seed = static_cast<uint32_t>(std::atoll(argv[++i]));
+        else {
+            std::cerr << "Uzycie: " << argv[0] << " [--games N] [--rooms N] [--room-size N] [--rules ID] [--seed N]" << std::endl;
+            return 1;
+        }
+    }
+    if (!findRules(config.rules)) {
+        std::cerr << "Nieznany zestaw zasad: " << config.rules << std::endl;
+        return 1;
+    }
+
+    Simulation sim(config);
+    auto start = Clock::now();
+    bool finished = sim.run();
+    auto elapsed = Clock::now() - start;
+    if (!finished) std::cerr << "Symulacja utknela w chwili " << sim.simulatedSeconds() << " s" << std::endl;
+    sim.report(elapsed);
+    return finished ? 0 : 1;
+}
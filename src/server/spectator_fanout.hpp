@@ -0,0 +1,257 @@
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <vector>
+#include <chrono>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <cerrno>
+#include "protocol.hpp"
+
+// Rozsylanie ramek do obserwatorow na osobnych watkach. Watek reaktora koduje
+// ramke raz i przekazuje wspolny bufor. Gniazdo obserwatora od chwili adopt
+// az do release ma jednego pisarza - watek rozsylajacy; reaktor wysyla mu
+// wszystko (takze odpowiedzi jak PONG czy ROOM_LIST) przez send(), zeby
+// ramki z obu zrodel nie przeplataly sie w strumieniu. Watki pracuja na
+// wlasnych kopiach (dup) deskryptorow, wiec zamkniecie i ponowne uzycie
+// numeru fd w watku reaktora nie trafi do niewlasciwego klienta. Wolny
+// obserwator dostaje tylko najnowsze odliczanie (TIME_LEFT), starsze sa
+// pomijane. Gdy mimo to kolejka sie zapelni, obserwator jest rozlaczany
+// (shutdown gniazda, reaktor widzi koniec strumienia i sprzata), zamiast
+// po cichu gubic ramki, ktorych nie da sie odtworzyc. Obok zwyklej ramki moze przyjsc jej skompresowana wersja dla
+// obserwatorow, ktorzy ja obsluguja.
+
+using SharedFrame = std::shared_ptr<const std::vector<char>>;
+
+class SpectatorFanout {
+public:
+    explicit SpectatorFanout(size_t workerCount = 2) {
+        for (size_t i = 0; i < workerCount; ++i) {
+            workers.push_back(std::make_unique<Worker>());
+        }
+        for (auto& w : workers) {
+            w->thread = std::thread(&Worker::loop, w.get());
+        }
+    }
+
+    ~SpectatorFanout() {
+        for (auto& w : workers) {
+            w->push(Command{Command::STOP, -1, -1, -1, nullptr, nullptr, false});
+            w->thread.join();
+        }
+    }
+
+    // Przejmuje zapis do gniazda fd; false, gdy nie udalo sie go skopiowac.
+    bool adopt(int fd, bool acceptsCompressed) {
+        int copy = dup(fd);
+        if (copy < 0) return false;
+        workerFor(fd).push(Command{Command::ADOPT, -1, fd, copy, nullptr, nullptr, acceptsCompressed});
+        return true;
+    }
+
+    // Oddaje gniazdo: ramki jeszcze nie wyslane przepadaja.
+    void release(int fd) {
+        workerFor(fd).push(Command{Command::RELEASE, -1, fd, -1, nullptr, nullptr, false});
+    }
+
+    void send(int fd, SharedFrame frame) {
+        workerFor(fd).push(Command{Command::SEND_ONE, -1, fd, -1, std::move(frame), nullptr, false});
+    }
+
+    void joinRoom(int roomId, int fd) {
+        workerFor(fd).push(Command{Command::JOIN, roomId, fd, -1, nullptr, nullptr, false});
+    }
+
+    void leaveRoom(int roomId, int fd) {
+        workerFor(fd).push(Command{Command::LEAVE, roomId, fd, -1, nullptr, nullptr, false});
+    }
+
+    void closeRoom(int roomId) {
+        for (auto& w : workers) {
+            w->push(Command{Command::CLOSE_ROOM, roomId, -1, -1, nullptr, nullptr, false});
+        }
+    }
+
+    // Obserwatorzy pokoju sa rozrzuceni po watkach wedlug fd, wiec ramka
+    // trafia do kazdego watku; watek bez obserwatorow pokoju ja pomija.
+    void publish(int roomId, MsgType type, SharedFrame frame, SharedFrame compressed = nullptr) {
+        for (auto& w : workers) {
+            w->push(Command{Command::PUBLISH, roomId, -1, -1, frame, compressed, type == MsgType::TIME_LEFT});
+        }
+    }
+
+private:
+    struct Command {
+        enum Kind { ADOPT, RELEASE, JOIN, LEAVE, CLOSE_ROOM, PUBLISH, SEND_ONE, STOP } kind;
+        int roomId;
+        int fd;
+        int dupFd;
+        SharedFrame frame;
+        SharedFrame compressed;
+        bool flag;  // PUBLISH: laczenie TIME_LEFT, ADOPT: obserwator przyjmuje kompresje
+    };
+
+    struct Pending {
+        SharedFrame frame;
+        bool coalesce;
+    };
+
+    struct Viewer {
+        int dupFd;
+        bool acceptsCompressed;
+        std::deque<Pending> queue;
+        size_t sentBytes = 0;
+        bool overflowed = false;
+    };
+
+    struct Worker {
+        static constexpr size_t maxQueued = 256;
+
+        std::thread thread;
+        std::mutex mtx;
+        std::condition_variable cv;
+        std::vector<Command> inbox;
+        std::map<int, Viewer> viewers;
+        std::map<int, std::vector<int>> rooms;
+
+        void push(Command cmd) {
+            {
+                std::lock_guard<std::mutex> lock(mtx);
+                inbox.push_back(std::move(cmd));
+            }
+            cv.notify_one();
+        }
+
+        void enqueue(Viewer& v, const SharedFrame& frame, bool coalesce) {
+            if (v.overflowed) return;
+            if (coalesce && !v.queue.empty() && v.queue.back().coalesce
+                && !(v.queue.size() == 1 && v.sentBytes > 0)) {
+                v.queue.back().frame = frame;
+                return;
+            }
+            if (v.queue.size() >= maxQueued) {
+                v.overflowed = true;
+                v.queue.clear();
+                v.sentBytes = 0;
+                shutdown(v.dupFd, SHUT_RDWR);
+                return;
+            }
+            v.queue.push_back({frame, coalesce});
+        }
+
+        void flush(Viewer& v) {
+            while (!v.queue.empty()) {
+                const auto& buf = *v.queue.front().frame;
+                ssize_t n = ::send(v.dupFd, buf.data() + v.sentBytes, buf.size() - v.sentBytes,
+                                 MSG_DONTWAIT | MSG_NOSIGNAL);
+                if (n < 0) {
+                    if (errno == EAGAIN || errno == EWOULDBLOCK) return;
+                    v.queue.clear();
+                    v.sentBytes = 0;
+                    return;
+                }
+                v.sentBytes += n;
+                if (v.sentBytes < buf.size()) return;
+                v.queue.pop_front();
+                v.sentBytes = 0;
+            }
+        }
+
+        Viewer* find(int fd) {
+            auto it = viewers.find(fd);
+            return it == viewers.end() ? nullptr : &it->second;
+        }
+
+        void leave(int roomId, int fd) {
+            auto it = rooms.find(roomId);
+            if (it == rooms.end()) return;
+            auto& members = it->second;
+            members.erase(std::remove(members.begin(), members.end(), fd), members.end());
+            if (members.empty()) rooms.erase(it);
+        }
+
+        bool apply(Command& cmd) {
+            switch (cmd.kind) {
+                case Command::ADOPT: {
+                    auto [it, added] = viewers.try_emplace(cmd.fd, Viewer{cmd.dupFd, cmd.flag, {}, 0, false});
+                    if (!added) close(cmd.dupFd);
+                    break;
+                }
+                case Command::RELEASE: {
+                    auto it = viewers.find(cmd.fd);
+                    if (it == viewers.end()) break;
+                    close(it->second.dupFd);
+                    viewers.erase(it);
+                    break;
+                }
+                case Command::JOIN:
+                    if (find(cmd.fd)) rooms[cmd.roomId].push_back(cmd.fd);
+                    break;
+                case Command::LEAVE:
+                    leave(cmd.roomId, cmd.fd);
+                    break;
+                case Command::CLOSE_ROOM:
+                    rooms.erase(cmd.roomId);
+                    break;
+                case Command::PUBLISH: {
+                    auto it = rooms.find(cmd.roomId);
+                    if (it == rooms.end()) break;
+                    for (int fd : it->second) {
+                        Viewer* v = find(fd);
+                        if (v) enqueue(*v, v->acceptsCompressed && cmd.compressed ? cmd.compressed : cmd.frame, cmd.flag);
+                    }
+                    break;
+                }
+                case Command::SEND_ONE:
+                    if (Viewer* v = find(cmd.fd)) enqueue(*v, cmd.frame, false);
+                    break;
+                case Command::STOP:
+                    return false;
+            }
+            return true;
+        }
+
+        void loop() {
+            std::vector<Command> batch;
+            bool running = true;
+            while (running) {
+                {
+                    std::unique_lock<std::mutex> lock(mtx);
+                    if (inbox.empty()) {
+                        if (hasBacklog()) cv.wait_for(lock, std::chrono::milliseconds(20));
+                        else cv.wait(lock, [this] { return !inbox.empty(); });
+                    }
+                    batch.swap(inbox);
+                }
+
+                for (auto& cmd : batch) {
+                    if (!apply(cmd)) running = false;
+                }
+                batch.clear();
+
+                for (auto& [fd, v] : viewers) flush(v);
+            }
+
+            for (auto& [fd, v] : viewers) close(v.dupFd);
+        }
+
+        bool hasBacklog() const {
+            for (const auto& [fd, v] : viewers) {
+                if (!v.queue.empty()) return true;
+            }
+            return false;
+        }
+    };
+
+    std::vector<std::unique_ptr<Worker>> workers;
+
+    Worker& workerFor(int fd) {
+        return *workers[static_cast<unsigned>(fd) % workers.size()];
+    }
+};
@@ -0,0 +1,267 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <map>
+#include <set>
+#include <unordered_map>
+#include <cstdio>
+#include <cstring>
+#include <cerrno>
+#include <iostream>
+#include <algorithm>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <fcntl.h>
+#include <unistd.h>
+#include "memory_usage.hpp"
+
+// Trwale statystyki graczy. Plik to posortowany po nicku snapshot, do ktorego
+// po kazdej grze dopisywane sa zmienione rekordy; przy starcie ostatni rekord
+// danego nicka wygrywa, a plik jest kompaktowany z powrotem do snapshotu.
+// Kompaktacja odbywa sie tez w trakcie pracy, gdy dopisane rekordy urosna
+// ponad rozmiar snapshotu, oraz po nieudanym dopisaniu - stan w pamieci jest
+// pelny, wiec wystarczy go zapisac od nowa. Ranking trzymany jest w pamieci,
+// wiec top-N nie dotyka dysku.
+//
+// Watek reaktora tylko aktualizuje mape i ranking i oddaje zmienione rekordy
+// watkowi zapisu (jak w dzienniku: partie zebrane od ostatniego obiegu ida
+// jednym write). Watek zapisu ma wlasna kopie statystyk, z ktorej robi
+// kompaktacje, wiec ani dopisywanie, ani przepisywanie pliku nie blokuje
+// reaktora.
+
+struct PlayerStats {
+    uint32_t gamesPlayed = 0;
+    uint64_t totalPoints = 0;
+    uint32_t answers = 0;
+    uint32_t uniqueAnswers = 0;
+};
+
+struct GameResult {
+    std::string nick;
+    int points = 0;
+    int answers = 0;
+    int uniqueAnswers = 0;
+};
+
+class StatsStore {
+public:
+    ~StatsStore() {
+        if (writer.joinable()) {
+            {
+                std::lock_guard<std::mutex> lock(mtx);
+                running = false;
+            }
+            cv.notify_one();
+            writer.join();
+        }
+        if (fd >= 0) close(fd);
+    }
+
+    bool open(const std::string& file) {
+        path = file;
+        load();
+        written = stats;
+        compact();
+        if (!reopen()) return false;
+        running = true;
+        writer = std::thread(&StatsStore::writerLoop, this);
+        return true;
+    }
+
+    void applyGame(const std::vector<GameResult>& results) {
+        std::vector<std::pair<std::string, PlayerStats>> changed;
+        for (const auto& r : results) {
+            if (r.nick.empty()) continue;
+            PlayerStats& s = stats[r.nick];
+            ranking.erase({s.totalPoints, r.nick});
+            s.gamesPlayed++;
+            s.totalPoints += r.points;
+            s.answers += r.answers;
+            s.uniqueAnswers += r.uniqueAnswers;
+            ranking.insert({s.totalPoints, r.nick});
+            if (writer.joinable()) changed.emplace_back(r.nick, s);
+        }
+        if (changed.empty()) return;
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            if (pending.empty()) pending.swap(changed);
+            else pending.insert(pending.end(), changed.begin(), changed.end());
+        }
+        changed.clear();
+        cv.notify_one();
+    }
+
+    std::string top(size_t n) const {
+        std::string out;
+        for (auto it = ranking.begin(); it != ranking.end() && n > 0; ++it, --n) {
+            const PlayerStats& s = stats.at(it->second);
+            int uniquePct = s.answers ? static_cast<int>(100 * s.uniqueAnswers / s.answers) : 0;
+            out += it->second + ":" + std::to_string(s.totalPoints) + ":" + std::to_string(s.gamesPlayed)
+                 + ":" + std::to_string(uniquePct) + ";";
+        }
+        return out;
+    }
+
+    size_t size() const {
+        return stats.size();
+    }
+
+    // Nick jest trzymany w mapie statystyk, w rankingu i - gdy jest plik - w
+    // kopii watku zapisu, ktora ma te same klucze co mapa.
+    size_t memoryBytes() const {
+        size_t maps = writer.joinable() ? 2 : 1;
+        size_t bytes = maps * stats.bucket_count() * sizeof(void*);
+        for (const auto& [nick, s] : stats) {
+            bytes += (maps + 1) * (kNodeOverhead + heapBytes(nick))
+                   + maps * sizeof(std::pair<const std::string, PlayerStats>) + sizeof(std::pair<uint64_t, std::string>);
+        }
+        return bytes;
+    }
+
+private:
+    static constexpr off_t kCompactMinBytes = 1 << 20;
+
+    struct RecordHeader {
+        uint16_t nickLen;
+        uint32_t gamesPlayed;
+        uint64_t totalPoints;
+        uint32_t answers;
+        uint32_t uniqueAnswers;
+    } __attribute__((packed));
+
+    std::string path;
+    int fd = -1;
+    off_t fileBytes = 0;
+    off_t snapshotBytes = 0;
+    bool compactPending = false;
+    std::unordered_map<std::string, PlayerStats> stats;
+    std::set<std::pair<uint64_t, std::string>, std::greater<>> ranking;
+
+    // Stan watku zapisu: fd, rozmiary pliku i kopia statystyk naleza do niego
+    // od chwili startu; z reaktorem dzieli tylko kolejke pending.
+    std::unordered_map<std::string, PlayerStats> written;
+    bool running = false;
+    std::thread writer;
+    std::mutex mtx;
+    std::condition_variable cv;
+    std::vector<std::pair<std::string, PlayerStats>> pending;
+
+    void writerLoop() {
+        std::vector<std::pair<std::string, PlayerStats>> batch;
+        std::string encoded;
+        std::unique_lock<std::mutex> lock(mtx);
+        while (true) {
+            cv.wait(lock, [this] { return !running || !pending.empty(); });
+            bool stop = !running;
+            batch.swap(pending);
+            lock.unlock();
+
+            if (!batch.empty()) {
+                for (const auto& [nick, s] : batch) {
+                    written[nick] = s;
+                    encode(encoded, nick, s);
+                }
+                if (fd >= 0) append(encoded);
+                encoded.clear();
+                batch.clear();
+            }
+
+            lock.lock();
+            if (stop && pending.empty()) break;
+        }
+    }
+
+    bool reopen() {
+        if (fd >= 0) close(fd);
+        fd = ::open(path.c_str(), O_WRONLY | O_APPEND | O_CREAT, 0644);
+        if (fd < 0) return false;
+        fileBytes = lseek(fd, 0, SEEK_END);
+        return true;
+    }
+
+    bool writeAll(const char* data, size_t size) {
+        size_t written = 0;
+        while (written < size) {
+            ssize_t n = ::write(fd, data + written, size - written);
+            if (n < 0 && errno == EINTR) continue;
+            if (n <= 0) return false;
+            written += n;
+        }
+        return true;
+    }
+
+    void append(const std::string& batch) {
+        if (writeAll(batch.data(), batch.size())) {
+            fileBytes += batch.size();
+        } else {
+            std::cerr << "Blad zapisu statystyk do " << path << ": " << strerror(errno) << std::endl;
+            // Urwany rekord przesunalby odczyt kolejnych, wiec plik wraca do
+            // poprzedniej dlugosci, a zmiany zapisze kompaktacja.
+            if (ftruncate(fd, fileBytes) < 0) {}
+            compactPending = true;
+        }
+        if (compactPending || fileBytes - snapshotBytes > std::max(snapshotBytes, kCompactMinBytes)) {
+            compactPending = !compact();
+            if (!compactPending && !reopen()) {
+                std::cerr << "Nie mozna ponownie otworzyc " << path << ": " << strerror(errno) << std::endl;
+            }
+        }
+    }
+
+    static void encode(std::string& out, const std::string& nick, const PlayerStats& s) {
+        RecordHeader h{static_cast<uint16_t>(nick.size()), s.gamesPlayed, s.totalPoints, s.answers, s.uniqueAnswers};
+        out.append(reinterpret_cast<const char*>(&h), sizeof(h));
+        out.append(nick);
+    }
+
+    void load() {
+        FILE* f = fopen(path.c_str(), "rb");
+        if (!f) return;
+        RecordHeader h;
+        std::string nick;
+        while (fread(&h, sizeof(h), 1, f) == 1) {
+            nick.resize(h.nickLen);
+            if (h.nickLen && fread(&nick[0], 1, h.nickLen, f) != h.nickLen) break;
+            stats[nick] = PlayerStats{h.gamesPlayed, h.totalPoints, h.answers, h.uniqueAnswers};
+        }
+        fclose(f);
+
+        for (const auto& [n, s] : stats) {
+            ranking.insert({s.totalPoints, n});
+        }
+    }
+
+    bool compact() {
+        std::map<std::string, PlayerStats> sorted(written.begin(), written.end());
+        std::string tmpPath = path + ".tmp";
+        FILE* f = fopen(tmpPath.c_str(), "wb");
+        if (!f) {
+            std::cerr << "Nie mozna utworzyc " << tmpPath << ": " << strerror(errno) << std::endl;
+            return false;
+        }
+        std::string buf;
+        off_t total = 0;
+        bool ok = true;
+        for (const auto& [n, s] : sorted) {
+            encode(buf, n, s);
+            if (buf.size() >= 64 * 1024) {
+                ok = ok && fwrite(buf.data(), 1, buf.size(), f) == buf.size();
+                total += buf.size();
+                buf.clear();
+            }
+        }
+        ok = ok && fwrite(buf.data(), 1, buf.size(), f) == buf.size();
+        total += buf.size();
+        ok = ok && fflush(f) == 0 && fsync(fileno(f)) == 0;
+        ok = fclose(f) == 0 && ok;
+        if (!ok || std::rename(tmpPath.c_str(), path.c_str()) != 0) {
+            std::cerr << "Kompaktacja statystyk " << path << " nie powiodla sie: " << strerror(errno) << std::endl;
+            std::remove(tmpPath.c_str());
+            return false;
+        }
+        snapshotBytes = total;
+        return true;
+    }
+};
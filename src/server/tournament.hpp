@@ -0,0 +1,115 @@
+#pragma once
+#include <algorithm>
+#include <chrono>
+#include <ctime>
+#include <deque>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+// Stan turnieju: kolejka zapisanych graczy, pokoje biezacego etapu i
+// zwyciezcy przechodzacy do kolejnego etapu. Gracze zapisani w trakcie
+// turnieju czekaja w kolejce na nastepny.
+
+struct TournamentConfig {
+    size_t roomSize = 4;
+    size_t minPlayers = 4;
+    int registrationSeconds = 30;
+    int startDelaySeconds = 5;
+    int stageBreakSeconds = 20;
+};
+
+struct Tournament {
+    std::deque<int> queue;
+    std::set<int> queued;
+    std::set<int> participants;
+
+    int stage = 0;
+    std::chrono::steady_clock::time_point stageClock;
+    std::set<int> activeRooms;
+    std::vector<int> winners;
+    std::map<std::string, int> totals;
+
+    time_t seatAt = 0;
+    time_t startAt = 0;
+    std::vector<int> pendingStart;
+
+    bool running() const {
+        return stage > 0;
+    }
+
+    bool stageRunning() const {
+        return !activeRooms.empty() || !pendingStart.empty();
+    }
+
+    bool enqueue(int fd) {
+        if (!queued.insert(fd).second) return false;
+        queue.push_back(fd);
+        return true;
+    }
+
+    void remove(int fd) {
+        queued.erase(fd);
+        participants.erase(fd);
+        winners.erase(std::remove(winners.begin(), winners.end(), fd), winners.end());
+    }
+
+    // Gracz odlaczony albo wznowiony na innym deskryptorze zachowuje miejsce.
+    void rekey(int from, int to) {
+        if (queued.erase(from)) {
+            queued.insert(to);
+            std::replace(queue.begin(), queue.end(), from, to);
+        }
+        if (participants.erase(from)) participants.insert(to);
+        std::replace(winners.begin(), winners.end(), from, to);
+    }
+
+    // Zdejmuje z kolejki do `count` graczy, pomijajac wpisy juz wypisane.
+    std::vector<int> take(size_t count) {
+        std::vector<int> taken;
+        taken.reserve(count);
+        while (!queue.empty() && taken.size() < count) {
+            int fd = queue.front();
+            queue.pop_front();
+            if (queued.erase(fd)) taken.push_back(fd);
+        }
+        return taken;
+    }
+
+    size_t waiting() const {
+        return queued.size();
+    }
+
+    void reset() {
+        stage = 0;
+        participants.clear();
+        activeRooms.clear();
+        winners.clear();
+        totals.clear();
+        pendingStart.clear();
+        seatAt = 0;
+        startAt = 0;
+    }
+};
+
+// Dzieli graczy na pokoje o rozmiarze co najwyzej roomSize, mozliwie rowno,
+// tak zeby zaden pokoj nie mial jednego gracza.
+inline std::vector<std::vector<int>> seatPlayers(const std::vector<int>& players, size_t roomSize) {
+    std::vector<std::vector<int>> tables;
+    if (players.size() < 2 || roomSize < 2) return tables;
+
+    size_t roomCount = (players.size() + roomSize - 1) / roomSize;
+    while (roomCount > 1 && players.size() / roomCount < 2) roomCount--;
+    tables.resize(roomCount);
+
+    size_t base = players.size() / roomCount;
+    size_t extra = players.size() % roomCount;
+    size_t next = 0;
+    for (size_t r = 0; r < roomCount; ++r) {
+        size_t size = base + (r < extra ? 1 : 0);
+        tables[r].assign(players.begin() + next, players.begin() + next + size);
+        next += size;
+    }
+    return tables;
+}
@@ -0,0 +1,166 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <cstdint>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <unistd.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+// Slady wykonania w formacie Chrome trace (chrome://tracing, Perfetto).
+// TraceSpan mierzy czas od konstrukcji do zniszczenia i zapisuje go do
+// pierscienia watku, ktory go utworzyl, bez blokad. Gdy sledzenie jest
+// wylaczone, span to jeden odczyt flagi. SIGUSR1 wlacza i wylacza
+// sledzenie, SIGUSR2 zleca zrzut ostatnich zdarzen; sam zapis robi petla
+// serwera (dumpIfRequested), bo w obsludze sygnalu nie wolno pisac plikow.
+
+inline std::atomic<bool> traceEnabled{false};
+inline volatile sig_atomic_t traceDumpRequested = 0;
+
+inline uint64_t traceTicks() {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+struct TraceEvent {
+    const char* name;
+    uint64_t start;
+    uint64_t end;
+    int64_t arg;
+};
+
+// Pierscien zdarzen jednego watku. Zapisuje tylko wlasciciel; zrzut z innego
+// watku odrzuca wpisy, ktore mogly zostac nadpisane w trakcie kopiowania.
+class TraceRing {
+public:
+    static constexpr size_t kCapacity = 1 << 16;
+
+    explicit TraceRing(uint32_t tid) : tid(tid), events(kCapacity) {}
+
+    void push(const TraceEvent& event) {
+        size_t at = head.load(std::memory_order_relaxed);
+        events[at % kCapacity] = event;
+        head.store(at + 1, std::memory_order_release);
+    }
+
+    void snapshot(std::vector<TraceEvent>& out) const {
+        size_t end = head.load(std::memory_order_acquire);
+        size_t begin = end > kCapacity ? end - kCapacity : 0;
+        std::vector<TraceEvent> copy;
+        copy.reserve(end - begin);
+        for (size_t i = begin; i < end; ++i) copy.push_back(events[i % kCapacity]);
+        size_t after = head.load(std::memory_order_acquire);
+        size_t valid = after > kCapacity ? after - kCapacity : 0;
+        size_t skip = valid > begin ? std::min(valid - begin, copy.size()) : 0;
+        out.insert(out.end(), copy.begin() + skip, copy.end());
+    }
+
+    const uint32_t tid;
+
+private:
+    std::vector<TraceEvent> events;
+    std::atomic<size_t> head{0};
+};
+
+class Tracer {
+public:
+    static Tracer& instance() {
+        static Tracer tracer;
+        return tracer;
+    }
+
+    // Pierscien biezacego watku, tworzony przy pierwszym zdarzeniu.
+    TraceRing& ring() {
+        thread_local TraceRing* local = nullptr;
+        if (!local) {
+            std::lock_guard<std::mutex> lock(mutex);
+            rings.push_back(std::make_unique<TraceRing>(static_cast<uint32_t>(rings.size()) + 1));
+            local = rings.back().get();
+        }
+        return *local;
+    }
+
+    // Zapisuje zawartosc wszystkich pierscieni jako tablice traceEvents.
+    bool dump(const std::string& path) {
+        double nsPerTick = calibrate();
+        std::ofstream out(path, std::ios::trunc);
+        if (!out) return false;
+
+        out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+        bool first = true;
+        std::vector<TraceEvent> events;
+        std::lock_guard<std::mutex> lock(mutex);
+        for (const auto& ring : rings) {
+            events.clear();
+            ring->snapshot(events);
+            for (const TraceEvent& e : events) {
+                double ts = (static_cast<double>(e.start) - static_cast<double>(baseTicks)) * nsPerTick / 1000.0;
+                double dur = static_cast<double>(e.end - e.start) * nsPerTick / 1000.0;
+                out << (first ? "\n" : ",\n") << std::fixed << std::setprecision(3)
+                    << "{\"name\":\"" << e.name << "\",\"ph\":\"X\",\"ts\":" << ts << ",\"dur\":" << dur
+                    << ",\"pid\":" << getpid() << ",\"tid\":" << ring->tid;
+                if (e.arg >= 0) out << ",\"args\":{\"id\":" << e.arg << "}";
+                out << "}";
+                first = false;
+            }
+        }
+        out << "\n]}\n";
+        return static_cast<bool>(out);
+    }
+
+    bool dumpIfRequested(const std::string& path) {
+        if (!traceDumpRequested) return false;
+        traceDumpRequested = 0;
+        return dump(path);
+    }
+
+    void installSignals() {
+        std::signal(SIGUSR1, [](int) { traceEnabled.store(!traceEnabled.load(std::memory_order_relaxed), std::memory_order_relaxed); });
+        std::signal(SIGUSR2, [](int) { traceDumpRequested = 1; });
+    }
+
+private:
+    std::mutex mutex;
+    std::vector<std::unique_ptr<TraceRing>> rings;
+    uint64_t baseTicks = traceTicks();
+    std::chrono::steady_clock::time_point baseTime = std::chrono::steady_clock::now();
+
+    // Przelicznik taktow licznika na nanosekundy, mierzony od startu.
+    double calibrate() const {
+        uint64_t ticks = traceTicks() - baseTicks;
+        double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - baseTime).count();
+        return ticks > 0 ? ns / static_cast<double>(ticks) : 1.0;
+    }
+};
+
+class TraceSpan {
+public:
+    explicit TraceSpan(const char* name, int64_t arg = -1)
+        : name(traceEnabled.load(std::memory_order_relaxed) ? name : nullptr), arg(arg) {
+        if (this->name) start = traceTicks();
+    }
+
+    ~TraceSpan() {
+        if (name) Tracer::instance().ring().push({name, start, traceTicks(), arg});
+    }
+
+    TraceSpan(const TraceSpan&) = delete;
+    TraceSpan& operator=(const TraceSpan&) = delete;
+
+private:
+    const char* name;
+    int64_t arg;
+    uint64_t start = 0;
+};
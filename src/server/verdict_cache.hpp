@@ -0,0 +1,318 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Pamiec werdyktow z glosowan: dla klucza (kategoria, litera, znormalizowane
+// slowo) liczniki rund, w ktorych odpowiedz przeszla albo odpadla. Gdy wynik
+// jest pewny, odpowiedz trafia do VERIFICATION_START juz oceniona i nikt na
+// nia nie glosuje.
+//
+// Pewnosc wymaga wielu rund z kilku roznych pokoi (odcisk pokoju to bit w
+// 16-bitowej masce), zeby jedna zmowiona para graczy nie ustalila werdyktu.
+// Co kRecheckEvery-ty pewny werdykt i tak idzie pod glosowanie, a jego wynik
+// wraca do licznikow. Liczniki starzeja sie: co kEpochRecords zapisow
+// zaczyna sie nowa epoka i slot dotkniety po k epokach ma je przesuniete o k
+// bitow w prawo, wiec dawne glosowania waza coraz mniej.
+//
+// Tablica ma stala wielkosc: zbiory po kWays slotow, wewnatrz zbioru
+// wymiana metoda CLOCK (bit odwolania). Slot trzyma tylko 64-bitowy skrot
+// klucza. Caly obszar jest zmapowany z pliku (MAP_SHARED), wiec przezywa
+// restart bez osobnego zapisu; bez pliku dziala tak samo w zwyklym buforze.
+// Uzywa jej tylko watek petli serwera, stad brak blokad.
+
+enum class Verdict : uint8_t {
+    UNKNOWN,
+    ACCEPTED,
+    REJECTED
+};
+
+// Male litery ASCII, polskie litery bez ogonkow (UTF-8), bez bialych znakow
+// na brzegach i z pojedynczymi spacjami w srodku.
+inline std::string normalizeAnswer(std::string_view word) {
+    static const struct { unsigned char lead, tail; char ascii; } kPolish[] = {
+        {0xC4, 0x84, 'a'}, {0xC4, 0x85, 'a'}, {0xC4, 0x86, 'c'}, {0xC4, 0x87, 'c'},
+        {0xC4, 0x98, 'e'}, {0xC4, 0x99, 'e'}, {0xC5, 0x81, 'l'}, {0xC5, 0x82, 'l'},
+        {0xC5, 0x83, 'n'}, {0xC5, 0x84, 'n'}, {0xC3, 0x93, 'o'}, {0xC3, 0xB3, 'o'},
+        {0xC5, 0x9A, 's'}, {0xC5, 0x9B, 's'}, {0xC5, 0xB9, 'z'}, {0xC5, 0xBA, 'z'},
+        {0xC5, 0xBB, 'z'}, {0xC5, 0xBC, 'z'},
+    };
+    std::string out;
+    out.reserve(word.size());
+    bool pendingSpace = false;
+    for (size_t i = 0; i < word.size(); ++i) {
+        unsigned char c = word[i];
+        if (c == ' ' || c == '\t') {
+            pendingSpace = !out.empty();
+            continue;
+        }
+        char mapped = 0;
+        if (c >= 0x80 && i + 1 < word.size()) {
+            for (const auto& p : kPolish) {
+                if (p.lead == c && p.tail == static_cast<unsigned char>(word[i + 1])) {
+                    mapped = p.ascii;
+                    ++i;
+                    break;
+                }
+            }
+        }
+        if (!mapped) mapped = (c >= 'A' && c <= 'Z') ? static_cast<char>(c - 'A' + 'a') : static_cast<char>(c);
+        if (pendingSpace) out += ' ';
+        pendingSpace = false;
+        out += mapped;
+    }
+    return out;
+}
+
+class VerdictCache {
+public:
+    static constexpr uint32_t kWays = 8;
+    // Tyle rund z werdyktem i roznych pokoi potrzeba, zanim wynik uznamy za
+    // pewny.
+    static constexpr uint32_t kMinRounds = 20;
+    static constexpr uint32_t kMinRooms = 4;
+    static constexpr uint32_t kRecheckEvery = 10;
+    static constexpr uint32_t kEpochRecords = 1u << 16;
+
+    // recheckEvery == 0 wylacza ponowne glosowania nad pewnymi werdyktami.
+    explicit VerdictCache(uint32_t sets = 4096, uint32_t recheckEvery = kRecheckEvery)
+        : setCount(sets), recheckEvery(recheckEvery), hands(sets, 0) {
+        useMemory();
+    }
+
+    ~VerdictCache() {
+        unmap();
+    }
+
+    VerdictCache(const VerdictCache&) = delete;
+    VerdictCache& operator=(const VerdictCache&) = delete;
+
+    // Przenosi tablice do pliku; plik o innym ukladzie jest zakladany od nowa.
+    bool open(const std::string& path) {
+        int fileFd = ::open(path.c_str(), O_RDWR | O_CREAT, 0644);
+        if (fileFd < 0) return false;
+
+        size_t size = mappedBytes();
+        struct stat st;
+        bool fresh = fstat(fileFd, &st) != 0 || static_cast<size_t>(st.st_size) != size;
+        if (fresh && ftruncate(fileFd, size) != 0) {
+            ::close(fileFd);
+            return false;
+        }
+        void* map = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fileFd, 0);
+        if (map == MAP_FAILED) {
+            ::close(fileFd);
+            return false;
+        }
+
+        unmap();
+        base = static_cast<char*>(map);
+        fd = fileFd;
+        if (fresh || !headerMatches()) initialize();
+        return true;
+    }
+
+    Verdict lookup(std::string_view category, char letter, std::string_view word) {
+        Slot* slot = find(keyOf(category, letter, word));
+        if (!slot) return Verdict::UNKNOWN;
+        slot->referenced = 1;
+        age(*slot);
+        Verdict verdict = confidentVerdict(*slot);
+        if (verdict != Verdict::UNKNOWN && recheckEvery && ++confidentLookups % recheckEvery == 0) {
+            return Verdict::UNKNOWN;
+        }
+        return verdict;
+    }
+
+    void record(std::string_view category, char letter, std::string_view word, bool accepted, int roomId) {
+        uint64_t key = keyOf(category, letter, word);
+        Slot* slot = find(key);
+        if (!slot) {
+            slot = victim(key);
+            *slot = Slot{};
+            slot->key = key;
+            slot->epoch = static_cast<uint8_t>(header()->epoch);
+        }
+        slot->referenced = 1;
+        age(*slot);
+        uint16_t& counter = accepted ? slot->accepts : slot->rejects;
+        if (counter == UINT16_MAX) {
+            // Nasycenie: polowimy oba liczniki, proporcja zostaje.
+            slot->accepts /= 2;
+            slot->rejects /= 2;
+        }
+        counter++;
+        slot->roomMask |= static_cast<uint16_t>(1u << roomBit(roomId));
+
+        FileHeader* h = header();
+        if (++h->epochRecords >= kEpochRecords) {
+            h->epochRecords = 0;
+            h->epoch++;
+        }
+    }
+
+    size_t size() const {
+        size_t used = 0;
+        for (size_t i = 0; i < static_cast<size_t>(setCount) * kWays; ++i) {
+            if (slots()[i].key != 0) used++;
+        }
+        return used;
+    }
+
+    // Pamiec slotow: zmapowany plik albo bufor w pamieci.
+    size_t memoryBytes() const {
+        return mappedBytes() + hands.capacity();
+    }
+
+private:
+    struct FileHeader {
+        char magic[4];
+        uint32_t version;
+        uint32_t sets;
+        uint32_t ways;
+        uint32_t epoch;
+        uint32_t epochRecords;
+    };
+
+    struct Slot {
+        uint64_t key;
+        uint16_t accepts;
+        uint16_t rejects;
+        uint16_t roomMask;
+        uint8_t referenced;
+        uint8_t epoch;
+    };
+    static_assert(sizeof(Slot) == 16, "Slot ma 16 bajtow, 4 sloty na linie cache");
+
+    uint32_t setCount;
+    uint32_t recheckEvery;
+    std::vector<uint8_t> hands;
+    std::vector<char> memory;
+    char* base = nullptr;
+    int fd = -1;
+    uint32_t confidentLookups = 0;
+
+    size_t mappedBytes() const {
+        return sizeof(FileHeader) + static_cast<size_t>(setCount) * kWays * sizeof(Slot);
+    }
+
+    FileHeader* header() const {
+        return reinterpret_cast<FileHeader*>(base);
+    }
+
+    Slot* slots() const {
+        return reinterpret_cast<Slot*>(base + sizeof(FileHeader));
+    }
+
+    static uint64_t keyOf(std::string_view category, char letter, std::string_view word) {
+        // FNV-1a po "kategoria\x1flitera\x1fslowo"; 0 oznacza pusty slot.
+        uint64_t hash = 0xcbf29ce484222325ULL;
+        auto mix = [&](std::string_view part) {
+            for (unsigned char c : part) {
+                hash ^= c;
+                hash *= 0x100000001b3ULL;
+            }
+            hash ^= 0x1f;
+            hash *= 0x100000001b3ULL;
+        };
+        mix(category);
+        char lower = (letter >= 'A' && letter <= 'Z') ? static_cast<char>(letter - 'A' + 'a') : letter;
+        mix(std::string_view(&lower, 1));
+        mix(normalizeAnswer(word));
+        return hash ? hash : 1;
+    }
+
+    static uint32_t roomBit(int roomId) {
+        uint32_t h = static_cast<uint32_t>(roomId) * 0x9E3779B1u;
+        return h >> 28;
+    }
+
+    // Leniwe starzenie: epoki, ktore minely od ostatniego dotkniecia slotu,
+    // polowia liczniki; slot bez glosow traci tez odciski pokoi.
+    void age(Slot& slot) const {
+        uint8_t current = static_cast<uint8_t>(header()->epoch);
+        uint32_t elapsed = static_cast<uint8_t>(current - slot.epoch);
+        if (elapsed == 0) return;
+        slot.epoch = current;
+        uint32_t shift = elapsed < 16 ? elapsed : 16;
+        slot.accepts = static_cast<uint16_t>(slot.accepts >> shift);
+        slot.rejects = static_cast<uint16_t>(slot.rejects >> shift);
+        if (slot.accepts == 0 && slot.rejects == 0) slot.roomMask = 0;
+    }
+
+    static Verdict confidentVerdict(const Slot& slot) {
+        uint32_t total = slot.accepts + slot.rejects;
+        if (total < kMinRounds) return Verdict::UNKNOWN;
+        if (static_cast<uint32_t>(__builtin_popcount(slot.roomMask)) < kMinRooms) return Verdict::UNKNOWN;
+        if (slot.accepts * 10u >= total * 9u) return Verdict::ACCEPTED;
+        if (slot.rejects * 10u >= total * 9u) return Verdict::REJECTED;
+        return Verdict::UNKNOWN;
+    }
+
+    Slot* setOf(uint64_t key) const {
+        return slots() + (key % setCount) * kWays;
+    }
+
+    Slot* find(uint64_t key) const {
+        Slot* set = setOf(key);
+        for (uint32_t w = 0; w < kWays; ++w) {
+            if (set[w].key == key) return &set[w];
+        }
+        return nullptr;
+    }
+
+    // CLOCK: wskazowka zbioru przechodzi po slotach, kasujac bit odwolania,
+    // az trafi na pusty albo nieuzywany od ostatniego obiegu.
+    Slot* victim(uint64_t key) {
+        Slot* set = setOf(key);
+        uint8_t& hand = hands[key % setCount];
+        while (true) {
+            Slot& slot = set[hand];
+            hand = (hand + 1) % kWays;
+            if (slot.key == 0 || !slot.referenced) return &slot;
+            slot.referenced = 0;
+        }
+    }
+
+    bool headerMatches() const {
+        const FileHeader* h = header();
+        return std::memcmp(h->magic, "PMVC", 4) == 0 && h->version == 2 && h->sets == setCount && h->ways == kWays;
+    }
+
+    void initialize() {
+        std::memset(base, 0, mappedBytes());
+        writeHeader();
+    }
+
+    void writeHeader() {
+        FileHeader* h = header();
+        std::memcpy(h->magic, "PMVC", 4);
+        h->version = 2;
+        h->sets = setCount;
+        h->ways = kWays;
+    }
+
+    void useMemory() {
+        memory.assign(mappedBytes(), 0);
+        base = memory.data();
+        writeHeader();
+    }
+
+    void unmap() {
+        if (!base) return;
+        if (fd >= 0) {
+            munmap(base, mappedBytes());
+            ::close(fd);
+        }
+        memory = std::vector<char>();
+        base = nullptr;
+        fd = -1;
+    }
+};
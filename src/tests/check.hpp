@@ -0,0 +1,45 @@
+#pragma once
+#include <iostream>
+#include <string>
+#include <vector>
+#include <unistd.h>
+
+// Testy jednostkowe bez zewnetrznej biblioteki: TEST rejestruje funkcje,
+// CHECK zlicza niespelnione warunki i wypisuje miejsce, a main.cpp
+// uruchamia wszystkie testy (albo te, ktorych nazwa zawiera argument).
+
+struct TestCase {
+    const char* name;
+    void (*fn)();
+};
+
+inline std::vector<TestCase>& testRegistry() {
+    static std::vector<TestCase> registry;
+    return registry;
+}
+
+inline int testFailures = 0;
+
+struct TestRegistrar {
+    TestRegistrar(const char* name, void (*fn)()) {
+        testRegistry().push_back({name, fn});
+    }
+};
+
+#define TEST(name)                                          \
+    static void name();                                     \
+    static TestRegistrar name##Registrar(#name, name);      \
+    static void name()
+
+#define CHECK(cond)                                                                  \
+    do {                                                                             \
+        if (!(cond)) {                                                               \
+            testFailures++;                                                          \
+            std::cerr << __FILE__ << ":" << __LINE__ << ": " << #cond << std::endl;  \
+        }                                                                            \
+    } while (0)
+
+// Sciezka pliku tymczasowego unikalna dla procesu; test sam ja usuwa.
+inline std::string testTempPath(const std::string& tag) {
+    return "/tmp/pm_test_" + tag + "_" + std::to_string(getpid());
+}
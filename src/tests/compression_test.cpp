@@ -0,0 +1,58 @@
+#include "check.hpp"
+#include "compression.hpp"
+#include <string>
+
+namespace {
+
+std::string roomList(size_t rooms) {
+    std::string list;
+    for (size_t i = 1; i <= rooms; ++i) {
+        list += std::to_string(i) + ":pokoj " + std::to_string(i) + ":" + std::to_string(i % 8) + (i % 3 ? ":waiting;" : ":inprogress;");
+    }
+    return list;
+}
+
+}
+
+TEST(compressionRoundTrip) {
+    std::string data = roomList(200);
+    std::vector<char> frame;
+    CHECK(compressFrame(MsgType::ROOM_LIST, data, frame));
+    CHECK(frame.size() < sizeof(MsgHeader) + data.size());
+
+    MsgHeader header;
+    std::memcpy(&header, frame.data(), sizeof(header));
+    CHECK(hasCompressedFlag(header.type));
+    CHECK(frameType(header.type) == MsgType::ROOM_LIST);
+    CHECK(ntohl(header.len) == frame.size() - sizeof(MsgHeader));
+
+    std::string out;
+    std::string_view body(frame.data() + sizeof(MsgHeader), frame.size() - sizeof(MsgHeader));
+    CHECK(decompressPayload(MsgType::ROOM_LIST, body, out));
+    CHECK(out == data);
+}
+
+TEST(compressionSkipsSmallPayloads) {
+    std::vector<char> frame;
+    CHECK(!compressFrame(MsgType::ROOM_LIST, "1:pokoj:2:waiting;", frame));
+}
+
+TEST(decompressionRejectsBrokenPayloads) {
+    std::string data = roomList(200);
+    std::vector<char> frame;
+    CHECK(compressFrame(MsgType::ROOM_LIST, data, frame));
+    std::string body(frame.begin() + sizeof(MsgHeader), frame.end());
+    std::string out;
+
+    // Uciety strumien.
+    CHECK(!decompressPayload(MsgType::ROOM_LIST, std::string_view(body).substr(0, body.size() / 2), out));
+    // Zadeklarowana dlugosc oryginalu inna niz faktyczna.
+    std::string wrongLen = body;
+    wrongLen[3] = static_cast<char>(wrongLen[3] + 1);
+    CHECK(!decompressPayload(MsgType::ROOM_LIST, wrongLen, out));
+    // Dlugosc ponad limit typu jest odrzucana przed alokacja.
+    std::string tooLong = body;
+    uint32_t huge = htonl(kMaxServerPayload + 1);
+    std::memcpy(&tooLong[0], &huge, sizeof(huge));
+    CHECK(!decompressPayload(MsgType::ROOM_LIST, tooLong, out));
+}
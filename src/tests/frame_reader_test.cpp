@@ -0,0 +1,92 @@
+#include "check.hpp"
+#include "frame_reader.hpp"
+
+TEST(frameReaderWaitsForWholeFrame) {
+    std::vector<char> wire = createMessage(MsgType::CREATE_ROOM, "pokoj");
+    FrameReader reader;
+    MsgHeader header{};
+    std::string_view body;
+
+    // Po bajcie: naglowek i tresc przychodza w kawalkach.
+    for (size_t i = 0; i + 1 < wire.size(); ++i) {
+        reader.append(wire.data() + i, 1);
+        CHECK(reader.next(MSG_TO_SERVER, header, body) == FrameReader::Status::NEED_MORE);
+    }
+    reader.append(wire.data() + wire.size() - 1, 1);
+    CHECK(reader.next(MSG_TO_SERVER, header, body) == FrameReader::Status::FRAME);
+    CHECK(header.type == MsgType::CREATE_ROOM);
+    CHECK(body == "pokoj");
+    CHECK(reader.buffered() == 0);
+    CHECK(reader.next(MSG_TO_SERVER, header, body) == FrameReader::Status::NEED_MORE);
+}
+
+TEST(frameReaderSplitsCoalescedFrames) {
+    std::vector<char> wire = createMessage(MsgType::LOGIN, "ala");
+    std::vector<char> second = createMessage(MsgType::JOIN_ROOM, "pokoj");
+    wire.insert(wire.end(), second.begin(), second.end());
+    wire.push_back(static_cast<char>(MsgType::START_GAME));
+
+    FrameReader reader;
+    reader.append(wire.data(), wire.size());
+    MsgHeader header{};
+    std::string_view body;
+    CHECK(reader.next(MSG_TO_SERVER, header, body) == FrameReader::Status::FRAME);
+    CHECK(header.type == MsgType::LOGIN && body == "ala");
+    CHECK(reader.next(MSG_TO_SERVER, header, body) == FrameReader::Status::FRAME);
+    CHECK(header.type == MsgType::JOIN_ROOM && body == "pokoj");
+    CHECK(reader.next(MSG_TO_SERVER, header, body) == FrameReader::Status::NEED_MORE);
+    CHECK(reader.buffered() == 1);
+}
+
+TEST(frameReaderRejectsInvalidHeaders) {
+    MsgHeader header{};
+    std::string_view body;
+
+    // Nieznany typ.
+    {
+        FrameReader reader;
+        MsgHeader bad{static_cast<MsgType>(0x7f), htonl(0)};
+        reader.append(reinterpret_cast<const char*>(&bad), sizeof(bad));
+        CHECK(reader.next(MSG_TO_SERVER, header, body) == FrameReader::Status::INVALID);
+    }
+    // Wiadomosc serwera wyslana przez klienta.
+    {
+        FrameReader reader;
+        std::vector<char> wire = createMessage(MsgType::LOGIN_OK, "token");
+        reader.append(wire.data(), wire.size());
+        CHECK(reader.next(MSG_TO_SERVER, header, body) == FrameReader::Status::INVALID);
+        CHECK(reader.next(MSG_TO_CLIENT, header, body) == FrameReader::Status::FRAME);
+    }
+    // Dlugosc ponad limit typu jest odrzucana od razu, bez czekania na tresc.
+    {
+        FrameReader reader;
+        MsgHeader big{MsgType::LOGIN, htonl(kMaxNameLen + 1)};
+        reader.append(reinterpret_cast<const char*>(&big), sizeof(big));
+        CHECK(reader.next(MSG_TO_SERVER, header, body) == FrameReader::Status::INVALID);
+    }
+    // Flaga kompresji tylko tam, gdzie protokol ja dopuszcza.
+    {
+        FrameReader reader;
+        MsgHeader packed{static_cast<MsgType>(static_cast<uint8_t>(MsgType::JOIN_ROOM) | kFrameFlagCompressed), htonl(0)};
+        reader.append(reinterpret_cast<const char*>(&packed), sizeof(packed));
+        CHECK(reader.next(MSG_TO_SERVER, header, body) == FrameReader::Status::INVALID);
+    }
+}
+
+TEST(frameReaderShrinkKeepsPendingBytes) {
+    FrameReader reader;
+    std::vector<char> large = createMessage(MsgType::SUBMIT_ANSWERS, std::string(kMaxAnswersLen, 'a'));
+    std::vector<char> small = createMessage(MsgType::LOGIN, "ala");
+    reader.append(large.data(), large.size());
+    reader.append(small.data(), 4);
+
+    MsgHeader header{};
+    std::string_view body;
+    CHECK(reader.next(MSG_TO_SERVER, header, body) == FrameReader::Status::FRAME);
+    reader.shrink(16);
+    CHECK(reader.capacity() == 16);
+    CHECK(reader.buffered() == 4);
+    reader.append(small.data() + 4, small.size() - 4);
+    CHECK(reader.next(MSG_TO_SERVER, header, body) == FrameReader::Status::FRAME);
+    CHECK(header.type == MsgType::LOGIN && body == "ala");
+}
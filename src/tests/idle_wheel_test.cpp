@@ -0,0 +1,44 @@
+#include "check.hpp"
+#include "../server/idle_wheel.hpp"
+#include <algorithm>
+
+namespace {
+
+std::vector<int> advanceTo(IdleWheel& wheel, time_t now) {
+    std::vector<int> due;
+    wheel.advance(now, [&](int fd, time_t) { due.push_back(fd); });
+    std::sort(due.begin(), due.end());
+    return due;
+}
+
+}
+
+TEST(idleWheelFiresOnlyDueEntries) {
+    IdleWheel wheel(64);
+    advanceTo(wheel, 100);
+    wheel.schedule(1, 101);
+    wheel.schedule(2, 102);
+    // Ten sam kubelek co 101, ale kolejne okrazenie kola.
+    wheel.schedule(3, 101 + 64);
+
+    CHECK(wheel.nextDue() == 101);
+    CHECK(advanceTo(wheel, 101) == std::vector<int>{1});
+    CHECK(wheel.nextDue() == 102);
+    CHECK(advanceTo(wheel, 102) == std::vector<int>{2});
+    CHECK(wheel.nextDue() == 101 + 64);
+    CHECK(advanceTo(wheel, 150).empty());
+    CHECK(advanceTo(wheel, 101 + 64) == std::vector<int>{3});
+    CHECK(wheel.nextDue() == 0);
+}
+
+TEST(idleWheelCatchesUpAfterLongGap) {
+    IdleWheel wheel(8);
+    advanceTo(wheel, 10);
+    wheel.schedule(1, 11);
+    wheel.schedule(2, 15);
+    wheel.schedule(3, 40);
+    // Przerwa dluzsza niz cale kolo: zalegle wpisy odpalaja sie od razu.
+    CHECK((advanceTo(wheel, 30) == std::vector<int>{1, 2}));
+    CHECK(wheel.nextDue() == 40);
+    CHECK(advanceTo(wheel, 40) == std::vector<int>{3});
+}
@@ -0,0 +1,99 @@
+#include "check.hpp"
+#include "../server/journal.hpp"
+#include <cstdio>
+#include <fstream>
+
+namespace {
+
+struct Replayed {
+    JournalEvent event;
+    uint32_t roomId;
+    std::string data;
+};
+
+std::vector<Replayed> replayAll(const std::string& path, size_t& count) {
+    std::vector<Replayed> out;
+    count = Journal::replay(path, [&](const JournalRecordHeader& h, const char* data) {
+        out.push_back({h.event, h.roomId, std::string(data, h.len)});
+    });
+    return out;
+}
+
+void writeJournal(const std::string& path) {
+    std::remove(path.c_str());
+    Journal journal;
+    CHECK(journal.open(path));
+    journal.append(JournalEvent::ROOM_CREATE, 1, "pokoj");
+    journal.append(JournalEvent::ROOM_JOIN, 1, "ala");
+    journal.append(JournalEvent::ROUND_START, 1, "K;1;3");
+    journal.close();
+}
+
+long fileSize(const std::string& path) {
+    std::ifstream in(path, std::ios::binary | std::ios::ate);
+    return static_cast<long>(in.tellg());
+}
+
+}
+
+TEST(journalReplaysRecordsInOrder) {
+    std::string path = testTempPath("journal");
+    writeJournal(path);
+    size_t count = 0;
+    auto records = replayAll(path, count);
+    CHECK(count == 3);
+    CHECK(records.size() == 3);
+    if (records.size() == 3) {
+        CHECK(records[0].event == JournalEvent::ROOM_CREATE && records[0].data == "pokoj");
+        CHECK(records[1].event == JournalEvent::ROOM_JOIN && records[1].data == "ala");
+        CHECK(records[2].roomId == 1 && records[2].data == "K;1;3");
+    }
+    std::remove(path.c_str());
+}
+
+TEST(journalTruncatesTornTail) {
+    std::string path = testTempPath("journal_tail");
+    writeJournal(path);
+    long valid = fileSize(path);
+
+    // Polowa naglowka i dane urwane w srodku, jak po awarii w trakcie zapisu.
+    JournalRecordHeader header{JournalEvent::ROOM_LEAVE, 1, 10, 0};
+    {
+        std::ofstream out(path, std::ios::binary | std::ios::app);
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out.write("al", 2);
+    }
+    size_t count = 0;
+    replayAll(path, count);
+    CHECK(count == 3);
+    CHECK(fileSize(path) == valid);
+
+    // Po obcieciu kolejne rekordy znow da sie odczytac.
+    {
+        Journal journal;
+        CHECK(journal.open(path));
+        journal.append(JournalEvent::GAME_END, 1, "");
+    }
+    auto records = replayAll(path, count);
+    CHECK(count == 4);
+    CHECK(!records.empty() && records.back().event == JournalEvent::GAME_END);
+    std::remove(path.c_str());
+}
+
+TEST(journalChecksumCoversHeader) {
+    std::string path = testTempPath("journal_header");
+    writeJournal(path);
+
+    // Zmiana numeru pokoju w drugim rekordzie (dane bez zmian) przerywa odczyt.
+    long second = static_cast<long>(sizeof(JournalRecordHeader)) + 5;
+    {
+        std::fstream io(path, std::ios::binary | std::ios::in | std::ios::out);
+        io.seekp(second + 1);
+        io.put(7);
+    }
+    size_t count = 0;
+    replayAll(path, count);
+    CHECK(count == 1);
+    CHECK(fileSize(path) == second);
+    std::remove(path.c_str());
+}
@@ -0,0 +1,48 @@
+#include "check.hpp"
+#include "../server/letter_draw.hpp"
+#include <set>
+#include <string>
+
+namespace {
+
+std::string drawGame(uint64_t seed, size_t rounds) {
+    LetterDraw draw;
+    draw.seed(seed);
+    std::string letters;
+    for (size_t i = 0; i < rounds; ++i) letters += draw.next();
+    return letters;
+}
+
+}
+
+TEST(letterDrawIsDeterministicPerSeed) {
+    CHECK(drawGame(42, 10) == drawGame(42, 10));
+    CHECK(drawGame(roomLetterSeed(7, 1), 10) == drawGame(roomLetterSeed(7, 1), 10));
+    CHECK(drawGame(roomLetterSeed(7, 1), 10) != drawGame(roomLetterSeed(7, 2), 10));
+    CHECK(drawGame(roomLetterSeed(7, 1), 10) != drawGame(roomLetterSeed(8, 1), 10));
+}
+
+TEST(letterDrawDoesNotRepeatWithinGame) {
+    for (uint64_t seed = 1; seed <= 100; ++seed) {
+        std::string letters = drawGame(seed, kLetterPoolSize);
+        std::set<char> distinct(letters.begin(), letters.end());
+        CHECK(distinct.size() == kLetterPoolSize);
+    }
+}
+
+TEST(letterDrawStartsOverWhenPoolIsUsed) {
+    LetterDraw draw;
+    draw.seed(3);
+    for (size_t i = 0; i < kLetterPoolSize; ++i) draw.next();
+    std::set<char> pool;
+    for (const auto& entry : kLetterPool) pool.insert(entry.letter);
+    CHECK(pool.count(draw.next()) == 1);
+}
+
+TEST(xoshiroBelowStaysInRange) {
+    Xoshiro128pp rng;
+    rng.seed(11);
+    for (uint32_t bound : {1u, 2u, 3u, 7u, 104u, 1000003u}) {
+        for (int i = 0; i < 1000; ++i) CHECK(rng.below(bound) < bound);
+    }
+}
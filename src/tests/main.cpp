@@ -0,0 +1,19 @@
+#include "check.hpp"
+#include <cstring>
+
+int main(int argc, char** argv) {
+    const char* filter = argc > 1 ? argv[1] : nullptr;
+    int run = 0;
+    int failed = 0;
+    for (const TestCase& test : testRegistry()) {
+        if (filter && !std::strstr(test.name, filter)) continue;
+        int before = testFailures;
+        test.fn();
+        run++;
+        bool ok = testFailures == before;
+        if (!ok) failed++;
+        std::cout << (ok ? "[ OK ] " : "[FAIL] ") << test.name << std::endl;
+    }
+    std::cout << "Testow: " << run << ", nieudanych: " << failed << std::endl;
+    return failed == 0 && run > 0 ? 0 : 1;
+}
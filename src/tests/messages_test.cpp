@@ -0,0 +1,54 @@
+#include "check.hpp"
+#include "messages.hpp"
+
+TEST(decodersSplitServerPayloads) {
+    auto started = decodeGameStarted("K;2;3;30;Panstwo,Miasto");
+    CHECK(started.fields == 5);
+    CHECK(started.letter == "K" && started.round == 2 && started.maxRounds == 3 && started.seconds == 30);
+    CHECK(started.categories == (std::vector<std::string_view>{"Panstwo", "Miasto"}));
+
+    auto members = decodeRoomMembers("pokoj;ala,,ola");
+    CHECK(members.room == "pokoj");
+    CHECK(members.players == (std::vector<std::string_view>{"ala", "ola"}));
+
+    auto resumed = decodeResumeOk("ala;;");
+    CHECK(resumed.nick == "ala" && resumed.room.empty() && resumed.players.empty());
+
+    auto verification = decodeVerification("Panstwo:Peru,,Polska:+?-;Miasto:Paryz;");
+    CHECK(verification.size() == 2);
+    CHECK(verification[0].answers == (std::vector<std::string_view>{"Peru", "Polska"}));
+    CHECK(verification[0].verdicts == "+-");
+    CHECK(verification[1].verdicts.empty());
+
+    auto rooms = decodeRoomList("1:pokoj:2:inprogress;stary:waiting;");
+    CHECK(rooms.size() == 2);
+    CHECK(rooms[0].name == "pokoj" && rooms[0].inProgress);
+    CHECK(rooms[1].name == "stary" && !rooms[1].inProgress);
+
+    auto tournament = decodeTournamentEnd("ala;3;ala:120;ola:80;");
+    CHECK(tournament.valid && tournament.winner == "ala" && tournament.stages == 3);
+    CHECK(tournament.standings.size() == 2);
+    CHECK(!decodeTournamentEnd("ala").valid);
+}
+
+TEST(decodersCheckClientPayloads) {
+    auto create = decodeCreateRoom("pokoj;krotkie");
+    CHECK(create.name == "pokoj" && create.hasRules && create.rulesId == "krotkie");
+    CHECK(!decodeCreateRoom("pokoj").hasRules);
+
+    CHECK(decodeLeaderboardRequest("") == 10);
+    CHECK(decodeLeaderboardRequest("0") == 1);
+    CHECK(decodeLeaderboardRequest("500") == 100);
+
+    CHECK(decodeResumeToken("00000000000000ff") == 255);
+    CHECK(decodeResumeToken("00000000000000FF") == 0);
+    CHECK(decodeResumeToken("ff") == 0);
+
+    std::vector<std::pair<size_t, std::string_view>> votes;
+    forEachVote("0:Peru;x:Kot;1:;2:a:b;1:Paryz;", [&](size_t category, std::string_view answer) {
+        votes.emplace_back(category, answer);
+    });
+    CHECK(votes.size() == 2);
+    CHECK(votes[0].first == 0 && votes[0].second == "Peru");
+    CHECK(votes[1].first == 1 && votes[1].second == "Paryz");
+}
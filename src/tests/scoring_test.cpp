@@ -0,0 +1,95 @@
+#include "check.hpp"
+#include "../server/game_logic.hpp"
+
+namespace {
+
+Room makeRoom(std::vector<int> players) {
+    Room room;
+    room.id = 1;
+    room.hostFd = players.front();
+    room.players = std::move(players);
+    room.rules = findRules("krotkie");
+    return room;
+}
+
+}
+
+TEST(quorumRuleAcceptsWithoutEnoughVoters) {
+    // Jeden gracz: nie ma kto glosowac.
+    CHECK(isAnswerAccepted(1, 1, 1));
+    // Ponizej polowy glosujacych nie ma kworum, glosy przeciw nic nie znacza.
+    CHECK(isAnswerAccepted(1, 1, 4));
+    CHECK(isAnswerAccepted(2, 2, 5));
+    // Z kworum odpowiedz odpada, gdy przeciw jest co najmniej polowa glosujacych.
+    CHECK(!isAnswerAccepted(1, 2, 4));
+    CHECK(isAnswerAccepted(1, 3, 4));
+    CHECK(!isAnswerAccepted(2, 3, 4));
+    // Gdy glosowali wszyscy, regula to dawne votesAgainst * 2 < totalPlayers.
+    for (int total = 2; total <= 8; ++total) {
+        for (int against = 0; against <= total; ++against) {
+            CHECK(isAnswerAccepted(against, total, total) == (against * 2 < total));
+        }
+    }
+}
+
+TEST(scoreRoundSplitsUniqueAndSharedPoints) {
+    Room room = makeRoom({3, 4, 5});
+    room.playerAnswers[3] = "Polska;Paryz;Kot";
+    room.playerAnswers[4] = "Peru;Paryz;";
+    room.playerAnswers[5] = "Polska;;Kura";
+    auto scores = scoreRound(room);
+    const RuleSet& rules = *room.rules;
+
+    CHECK(scores.size() == 3);
+    if (scores.size() != 3) return;
+    CHECK(scores[0].points == rules.sharedPoints * 2 + rules.uniquePoints);
+    CHECK(scores[0].accepted == 3 && scores[0].unique == 1);
+    CHECK(scores[1].points == rules.uniquePoints + rules.sharedPoints);
+    CHECK(scores[2].points == rules.sharedPoints + rules.uniquePoints);
+}
+
+TEST(scoreRoundAppliesVotesWithQuorum) {
+    Room room = makeRoom({3, 4, 5, 6});
+    room.playerAnswers[3] = "Polska;Pcim;Pies";
+    room.playerAnswers[4] = "Polska;;";
+    // Dwa glosy z czterech to kworum; oba przeciw "Pcim".
+    room.playerVotes[5] = "1:Pcim;";
+    room.playerVotes[6] = "1:Pcim;";
+    auto scores = scoreRound(room);
+    const RuleSet& rules = *room.rules;
+
+    CHECK(scores[0].points == rules.sharedPoints + rules.uniquePoints);
+    CHECK(scores[0].accepted == 2);
+    // Jeden glos przeciw z dwoch to polowa - odpowiedz odpada.
+    room.playerVotes[5] = "0:Polska;";
+    scores = scoreRound(room);
+    CHECK(scores[0].points == rules.uniquePoints);
+    CHECK(scores[1].points == 0);
+    CHECK(scores[2].points == 0 && scores[3].points == 0);
+
+    // Bez kworum (jeden glosujacy z czterech) glosy sa pomijane.
+    room.playerVotes.erase(6);
+    scores = scoreRound(room);
+    CHECK(scores[0].points == rules.sharedPoints + 2 * rules.uniquePoints);
+}
+
+TEST(scoreRoundUsesKnownVerdicts) {
+    Room room = makeRoom({3, 4});
+    room.playerAnswers[3] = "Polska;Xyz;";
+    room.playerAnswers[4] = "Peru;;";
+    room.knownVerdicts.resize(room.rules->categoryCount());
+    room.knownVerdicts[1]["Xyz"] = false;
+    room.knownVerdicts[0]["Peru"] = true;
+    // Glos przeciw "Peru" nie zmienia werdyktu z pamieci.
+    room.playerVotes[3] = "0:Peru;";
+    room.playerVotes[4] = "";
+    auto scores = scoreRound(room);
+    CHECK(scores[0].accepted == 1);
+    CHECK(scores[1].accepted == 1);
+}
+
+TEST(sanitizedAnswersKeepFieldCount) {
+    CHECK(sanitizeAnswers("Polska;Pa:ryz;Kot,Pies;") == "Polska;;;");
+    CHECK(sanitizeAnswers(";;") == ";;");
+    CHECK(sanitizeAnswers("Peru") == "Peru");
+}
@@ -0,0 +1,48 @@
+#include "check.hpp"
+#include "../server/session_table.hpp"
+#include "../server/letter_draw.hpp"
+#include <map>
+
+TEST(sessionTableEraseKeepsProbeChains) {
+    SessionTable table;
+    // Wszystkie tokeny maja ten sam slot domowy (dolne bity), ostatnie
+    // zawijaja sie na poczatek tablicy.
+    std::vector<uint64_t> tokens;
+    for (uint64_t k = 1; k <= 6; ++k) tokens.push_back(k * 16 + 13);
+    for (size_t i = 0; i < tokens.size(); ++i) table.set(tokens[i], static_cast<int>(i));
+
+    table.erase(tokens[1]);
+    table.erase(tokens[4]);
+    CHECK(table.size() == 4);
+    CHECK(table.find(tokens[1]) == SessionTable::kNotFound);
+    CHECK(table.find(tokens[4]) == SessionTable::kNotFound);
+    for (size_t i : {0, 2, 3, 5}) CHECK(table.find(tokens[i]) == static_cast<int>(i));
+
+    table.erase(tokens[1]);
+    CHECK(table.size() == 4);
+    table.set(tokens[3], -7);
+    CHECK(table.find(tokens[3]) == -7);
+    CHECK(table.find(0) == SessionTable::kNotFound);
+}
+
+TEST(sessionTableMatchesMapUnderChurn) {
+    SessionTable table;
+    std::map<uint64_t, int> expected;
+    uint64_t state = 5;
+    for (int step = 0; step < 20000; ++step) {
+        // Maly zbior tokenow, zeby czesto trafiac w istniejace wpisy.
+        uint64_t token = splitMix64(state) % 512 + 1;
+        if (state % 3 == 0) {
+            table.erase(token);
+            expected.erase(token);
+        } else {
+            table.set(token, step);
+            expected[token] = step;
+        }
+    }
+    CHECK(table.size() == expected.size());
+    for (uint64_t token = 1; token <= 512; ++token) {
+        auto it = expected.find(token);
+        CHECK(table.find(token) == (it == expected.end() ? SessionTable::kNotFound : it->second));
+    }
+}
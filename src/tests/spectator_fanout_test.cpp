@@ -0,0 +1,65 @@
+#include "check.hpp"
+#include "../server/spectator_fanout.hpp"
+#include <poll.h>
+
+namespace {
+
+SharedFrame frameOf(size_t size, char fill) {
+    return std::make_shared<const std::vector<char>>(size, fill);
+}
+
+// Czyta do konca strumienia albo do przerwy dluzszej niz timeoutMs.
+size_t drain(int fd, bool& eof, int timeoutMs = 2000) {
+    size_t total = 0;
+    eof = false;
+    char buf[65536];
+    while (true) {
+        pollfd p{fd, POLLIN, 0};
+        if (poll(&p, 1, timeoutMs) <= 0) return total;
+        ssize_t n = recv(fd, buf, sizeof(buf), 0);
+        if (n <= 0) {
+            eof = true;
+            return total;
+        }
+        total += n;
+    }
+}
+
+}
+
+TEST(fanoutDeliversEveryFrameToReadingViewer) {
+    int fds[2];
+    CHECK(socketpair(AF_UNIX, SOCK_STREAM, 0, fds) == 0);
+    {
+        SpectatorFanout fanout(1);
+        CHECK(fanout.adopt(fds[0], false));
+        fanout.joinRoom(1, fds[0]);
+        for (int i = 0; i < 10; ++i) fanout.publish(1, MsgType::ROUND_END, frameOf(100, 'a' + i));
+        bool eof = false;
+        CHECK(drain(fds[1], eof, 300) == 1000);
+        CHECK(!eof);
+    }
+    close(fds[0]);
+    close(fds[1]);
+}
+
+TEST(fanoutDisconnectsViewerOnQueueOverflow) {
+    int fds[2];
+    CHECK(socketpair(AF_UNIX, SOCK_STREAM, 0, fds) == 0);
+    int small = 4096;
+    setsockopt(fds[0], SOL_SOCKET, SO_SNDBUF, &small, sizeof(small));
+    {
+        SpectatorFanout fanout(1);
+        CHECK(fanout.adopt(fds[0], false));
+        fanout.joinRoom(1, fds[0]);
+        // Obserwator nie czyta: kolejka rosnie az do limitu i zamiast gubic
+        // ramki po cichu watek zamyka polaczenie.
+        for (int i = 0; i < 2000; ++i) fanout.publish(1, MsgType::ROUND_END, frameOf(1024, 'x'));
+        bool eof = false;
+        size_t received = drain(fds[1], eof);
+        CHECK(eof);
+        CHECK(received < 2000u * 1024);
+    }
+    close(fds[0]);
+    close(fds[1]);
+}
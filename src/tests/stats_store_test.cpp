@@ -0,0 +1,24 @@
+#include "check.hpp"
+#include "../server/stats_store.hpp"
+#include <cstdio>
+
+TEST(statsStoreWritesInBackgroundAndReloads) {
+    std::string path = testTempPath("stats");
+    std::remove(path.c_str());
+    {
+        StatsStore store;
+        CHECK(store.open(path));
+        store.applyGame({{"ala", 40, 4, 2}, {"ola", 10, 2, 0}});
+        store.applyGame({{"ala", 20, 2, 0}, {"ela", 30, 3, 3}});
+        CHECK(store.top(2) == "ala:60:2:33;ela:30:1:100;");
+    }
+    {
+        // Destruktor czeka, az watek zapisu wypisze kolejke.
+        StatsStore store;
+        CHECK(store.open(path));
+        CHECK(store.size() == 3);
+        CHECK(store.top(3) == "ala:60:2:33;ela:30:1:100;ola:10:1:0;");
+    }
+    std::remove(path.c_str());
+    std::remove((path + ".tmp").c_str());
+}
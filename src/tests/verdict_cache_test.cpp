@@ -0,0 +1,107 @@
+#include "check.hpp"
+#include "../server/verdict_cache.hpp"
+#include <cstdio>
+
+namespace {
+
+std::string word(int i) {
+    return "Slowo" + std::to_string(i);
+}
+
+// Glosowania z kolejnych pokoi, wiec odciski pokoi sa rozne.
+void learn(VerdictCache& cache, const std::string& w, bool accepted) {
+    for (uint32_t i = 0; i < VerdictCache::kMinRounds; ++i) cache.record("Miasto", 'S', w, accepted, i);
+}
+
+}
+
+TEST(verdictCacheNeedsConsistentRounds) {
+    VerdictCache cache(16, 0);
+    cache.record("Miasto", 'S', "Szczecin", true, 1);
+    CHECK(cache.lookup("Miasto", 'S', "Szczecin") == Verdict::UNKNOWN);
+    learn(cache, "Szczecin", true);
+    CHECK(cache.lookup("Miasto", 's', "  SZCZECIN ") == Verdict::ACCEPTED);
+    CHECK(cache.lookup("Panstwo", 'S', "Szczecin") == Verdict::UNKNOWN);
+    learn(cache, "Sosna", false);
+    CHECK(cache.lookup("Miasto", 'S', "Sosna") == Verdict::REJECTED);
+    // Sprzeczne glosowania: wynik przestaje byc pewny.
+    learn(cache, "Sosna", true);
+    CHECK(cache.lookup("Miasto", 'S', "Sosna") == Verdict::UNKNOWN);
+}
+
+TEST(verdictCacheNeedsSeveralRooms) {
+    VerdictCache cache(16, 0);
+    for (int i = 0; i < 100; ++i) cache.record("Miasto", 'S', "Sanok", true, 7);
+    CHECK(cache.lookup("Miasto", 'S', "Sanok") == Verdict::UNKNOWN);
+    for (int room = 100; room < 120; ++room) cache.record("Miasto", 'S', "Sanok", true, room);
+    CHECK(cache.lookup("Miasto", 'S', "Sanok") == Verdict::ACCEPTED);
+}
+
+TEST(verdictCacheSendsSomeVerdictsToVote) {
+    VerdictCache cache(16, 3);
+    learn(cache, "Sopot", true);
+    CHECK(cache.lookup("Miasto", 'S', "Sopot") == Verdict::ACCEPTED);
+    CHECK(cache.lookup("Miasto", 'S', "Sopot") == Verdict::ACCEPTED);
+    CHECK(cache.lookup("Miasto", 'S', "Sopot") == Verdict::UNKNOWN);
+    CHECK(cache.lookup("Miasto", 'S', "Sopot") == Verdict::ACCEPTED);
+}
+
+TEST(verdictCacheAgesCounters) {
+    VerdictCache cache(16, 0);
+    learn(cache, "Sopot", true);
+    CHECK(cache.lookup("Miasto", 'S', "Sopot") == Verdict::ACCEPTED);
+    // Pelna epoka zapisow innego slowa: liczniki Sopotu spadaja o polowe,
+    // ponizej progu pewnosci.
+    for (uint32_t i = 0; i < VerdictCache::kEpochRecords; ++i) cache.record("Miasto", 'S', "Sanok", true, 1);
+    CHECK(cache.lookup("Miasto", 'S', "Sopot") == Verdict::UNKNOWN);
+    learn(cache, "Sopot", true);
+    CHECK(cache.lookup("Miasto", 'S', "Sopot") == Verdict::ACCEPTED);
+}
+
+TEST(verdictCacheEvictsUnreferencedFirst) {
+    // Jeden zbior: kazdy nowy klucz konkuruje o te same kWays slotow.
+    VerdictCache cache(1, 0);
+    for (uint32_t i = 0; i < VerdictCache::kWays; ++i) learn(cache, word(i), true);
+    CHECK(cache.size() == VerdictCache::kWays);
+
+    // Wszystkie sloty maja bit odwolania: wskazowka robi pelny obieg i
+    // wyrzuca pierwszy.
+    learn(cache, word(100), true);
+    CHECK(cache.lookup("Miasto", 'S', word(0)) == Verdict::UNKNOWN);
+    CHECK(cache.size() == VerdictCache::kWays);
+
+    // Slot 1 uzyty od ostatniego obiegu przezywa, odpada nastepny.
+    CHECK(cache.lookup("Miasto", 'S', word(1)) == Verdict::ACCEPTED);
+    learn(cache, word(101), true);
+    CHECK(cache.lookup("Miasto", 'S', word(1)) == Verdict::ACCEPTED);
+    CHECK(cache.lookup("Miasto", 'S', word(2)) == Verdict::UNKNOWN);
+    CHECK(cache.lookup("Miasto", 'S', word(101)) == Verdict::ACCEPTED);
+}
+
+TEST(verdictCachePersistsInFile) {
+    std::string path = testTempPath("verdicts");
+    std::remove(path.c_str());
+    {
+        VerdictCache cache(16, 0);
+        CHECK(cache.open(path));
+        learn(cache, "Sopot", true);
+    }
+    {
+        VerdictCache cache(16, 0);
+        CHECK(cache.open(path));
+        CHECK(cache.lookup("Miasto", 'S', "Sopot") == Verdict::ACCEPTED);
+    }
+    {
+        // Inny uklad tablicy: plik zakladany od nowa.
+        VerdictCache cache(32, 0);
+        CHECK(cache.open(path));
+        CHECK(cache.lookup("Miasto", 'S', "Sopot") == Verdict::UNKNOWN);
+    }
+    std::remove(path.c_str());
+}
+
+TEST(normalizeAnswerFoldsCaseAndPolishLetters) {
+    CHECK(normalizeAnswer("  Łódź   Kaliska ") == "lodz kaliska");
+    CHECK(normalizeAnswer("ŻÓŁW") == "zolw");
+    CHECK(normalizeAnswer("") == "");
+}